@@ -0,0 +1,215 @@
+// Microbenchmark: DetectionParser::parseText against the previous
+// QString::split based parser of UdpHandler::parseDetectionData.
+//
+// Usage: parser_bench [capture.txt] [iterations]
+// The capture file holds raw datagrams separated by empty lines. Without
+// one, a synthetic capture in the sensor's text format is generated.
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QString>
+#include <QStringList>
+#include <QElapsedTimer>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <vector>
+#include "../detectionparser.h"
+
+namespace {
+
+// Reference implementation: the parser this benchmark replaced
+void parseLegacy(const QByteArray& datagram, std::vector<DetectionData>& out)
+{
+    QString data = QString::fromUtf8(datagram);
+    QStringList lines = data.split("\n", Qt::SkipEmptyParts);
+
+    DetectionData targets;
+    for (const QString& line : lines) {
+        QStringList parts = line.split(" ", Qt::SkipEmptyParts);
+        for (int i = 0; i < parts.size(); ++i) {
+            if (parts[i] == "TgtId:" && i + 1 < parts.size())
+                targets.target_id = parts[i + 1].toInt();
+            if (parts[i] == "Range:" && i + 1 < parts.size())
+                targets.radius = parts[i + 1].toFloat();
+            if (parts[i] == "Speed:" && i + 1 < parts.size())
+                targets.radial_speed = parts[i + 1].toFloat();
+            if (parts[i] == "azimuth:" && i + 1 < parts.size())
+                targets.azimuth = parts[i + 1].toFloat();
+            if (parts[i] == "amplitude:" && i + 1 < parts.size())
+                targets.amplitude = parts[i + 1].toFloat();
+            if (parts[i] == "timestamp:" && i + 1 < parts.size())
+                targets.timestamp = parts[i + 1].toInt();
+        }
+        out.push_back(targets);
+    }
+}
+
+bool sameValue(float a, float b)
+{
+    return std::fabs(a - b) <= 1e-6f + 1e-5f * std::max(std::fabs(a), std::fabs(b));
+}
+
+// The legacy parser read timestamps with toInt(), which gives 0 for
+// millisecond epoch values; parseText keeps them, as intended
+bool sameTimestamp(qint64 legacy, qint64 current)
+{
+    bool fitsInt = current >= std::numeric_limits<int>::min() && current <= std::numeric_limits<int>::max();
+    return legacy == current || (!fitsInt && legacy == 0);
+}
+
+bool sameDetection(const DetectionData& legacy, const DetectionData& current)
+{
+    return legacy.target_id == current.target_id && sameValue(legacy.radius, current.radius) &&
+           sameValue(legacy.radial_speed, current.radial_speed) && sameValue(legacy.azimuth, current.azimuth) &&
+           sameValue(legacy.amplitude, current.amplitude) && sameTimestamp(legacy.timestamp, current.timestamp);
+}
+
+void printDetection(const char* name, const DetectionData& detection)
+{
+    std::fprintf(stderr, "  %-9s TgtId %u Range %g Speed %g azimuth %g amplitude %g timestamp %lld\n", name,
+                 detection.target_id, detection.radius, detection.radial_speed, detection.azimuth,
+                 detection.amplitude, static_cast<long long>(detection.timestamp));
+}
+
+std::vector<QByteArray> loadCapture(const QString& path)
+{
+    std::vector<QByteArray> datagrams;
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return datagrams;
+    }
+
+    QByteArray current;
+    while (!file.atEnd()) {
+        QByteArray line = file.readLine();
+        if (line.trimmed().isEmpty()) {
+            if (!current.isEmpty()) {
+                datagrams.push_back(current);
+                current.clear();
+            }
+            continue;
+        }
+        current.append(line);
+    }
+    if (!current.isEmpty()) {
+        datagrams.push_back(current);
+    }
+    return datagrams;
+}
+
+std::vector<QByteArray> syntheticCapture(int packets, int targetsPerPacket)
+{
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<> range(0.5, 100.0);
+    std::uniform_real_distribution<> speed(-30.0, 30.0);
+    std::uniform_real_distribution<> azimuth(-60.0, 60.0);
+    std::uniform_real_distribution<> amplitude(0.0, 60.0);
+
+    std::vector<QByteArray> datagrams;
+    datagrams.reserve(packets);
+    for (int p = 0; p < packets; ++p) {
+        QByteArray datagram;
+        for (int t = 0; t < targetsPerPacket; ++t) {
+            datagram.append(QString("TgtId: %1 Range: %2 Speed: %3 azimuth: %4 amplitude: %5 timestamp: %6\n")
+                            .arg(t + 1)
+                            .arg(range(gen), 0, 'f', 2)
+                            .arg(speed(gen), 0, 'f', 2)
+                            .arg(azimuth(gen), 0, 'f', 2)
+                            .arg(amplitude(gen), 0, 'f', 1)
+                            .arg(100000 + p * 50)
+                            .toLatin1());
+        }
+        datagrams.push_back(datagram);
+    }
+    return datagrams;
+}
+
+template <typename Parser>
+double run(const char* name, const std::vector<QByteArray>& datagrams, int iterations,
+           size_t totalBytes, Parser parse)
+{
+    std::vector<DetectionData> out;
+    out.reserve(256);
+    size_t detections = 0;
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < iterations; ++i) {
+        for (const QByteArray& datagram : datagrams) {
+            out.clear();
+            parse(datagram, out);
+            detections += out.size();
+        }
+    }
+    double seconds = timer.nsecsElapsed() / 1e9;
+
+    double packets = static_cast<double>(datagrams.size()) * iterations;
+    std::printf("%-10s %8.3f s  %12.0f packets/s  %12.0f detections/s  %8.1f MB/s  %7.1f ns/detection\n",
+                name, seconds, packets / seconds, detections / seconds,
+                totalBytes * static_cast<double>(iterations) / seconds / 1e6,
+                seconds * 1e9 / qMax<size_t>(detections, 1));
+    return seconds;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    std::vector<QByteArray> datagrams;
+    if (argc > 1) {
+        datagrams = loadCapture(QString::fromLocal8Bit(argv[1]));
+        if (datagrams.empty()) {
+            std::fprintf(stderr, "No datagrams in %s\n", argv[1]);
+            return 1;
+        }
+    } else {
+        datagrams = syntheticCapture(10000, 5);
+    }
+    int iterations = argc > 2 ? QString(argv[2]).toInt() : 20;
+
+    size_t totalBytes = 0;
+    for (const QByteArray& datagram : datagrams) {
+        totalBytes += datagram.size();
+    }
+    std::printf("%zu datagrams, %zu bytes, %d iterations\n", datagrams.size(), totalBytes, iterations);
+
+    // Both parsers must agree, field by field, before timing them
+    std::vector<DetectionData> legacy, current;
+    for (size_t index = 0; index < datagrams.size(); ++index) {
+        const QByteArray& datagram = datagrams[index];
+        legacy.clear();
+        current.clear();
+        parseLegacy(datagram, legacy);
+        DetectionParser::parseText(datagram.constData(), datagram.size(), current);
+        if (legacy.size() != current.size()) {
+            std::fprintf(stderr, "datagram %zu: legacy produced %zu detections, parseText %zu\n",
+                         index, legacy.size(), current.size());
+            return 1;
+        }
+        for (size_t i = 0; i < legacy.size(); ++i) {
+            if (!sameDetection(legacy[i], current[i])) {
+                std::fprintf(stderr, "datagram %zu, detection %zu differs:\n", index, i);
+                printDetection("legacy", legacy[i]);
+                printDetection("parseText", current[i]);
+                return 1;
+            }
+        }
+    }
+
+    double legacySeconds = run("legacy", datagrams, iterations, totalBytes,
+        [](const QByteArray& datagram, std::vector<DetectionData>& out) {
+            parseLegacy(datagram, out);
+        });
+    double parserSeconds = run("parseText", datagrams, iterations, totalBytes,
+        [](const QByteArray& datagram, std::vector<DetectionData>& out) {
+            DetectionParser::parseText(datagram.constData(), datagram.size(), out);
+        });
+
+    std::printf("speedup: %.1fx\n", legacySeconds / parserSeconds);
+    return 0;
+}
@@ -0,0 +1,427 @@
+// Google Benchmark suite for the ingest, parsing and storage hot paths.
+//
+// Usage: radar_bench [--benchmark_filter=<regex>] [other Google Benchmark flags]
+//
+// Every benchmark reports detections/s and bytes/s (the CRC16 engines only
+// bytes/s), so a regression in the parsers, the detection store, the track
+// store, the target associator or the checksums shows up as a drop in
+// throughput rather than only as a change in ns per iteration.
+
+#include <benchmark/benchmark.h>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QProcess>
+#include <cstdio>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "../udphandler.h"
+#include "../crc16.h"
+#include "../radarlog.h"
+#include "../trackstore.h"
+#include "../trackassociator.h"
+
+namespace {
+
+// Distinct datagrams cycled through by the parser benchmarks
+const int DATAGRAM_POOL = 256;
+
+enum Encoding {
+    TextEncoding,
+    BinaryEncoding
+};
+
+std::vector<DetectionData> syntheticDetections(int count, std::mt19937& gen, qint64 timestamp)
+{
+    std::uniform_real_distribution<> range(0.5, 100.0);
+    std::uniform_real_distribution<> speed(-30.0, 30.0);
+    std::uniform_real_distribution<> azimuth(-60.0, 60.0);
+    std::uniform_real_distribution<> amplitude(0.0, 60.0);
+
+    std::vector<DetectionData> detections(count);
+    for (int i = 0; i < count; ++i) {
+        DetectionData& d = detections[i];
+        d.target_id = static_cast<uint32_t>(i + 1);
+        d.radius = static_cast<float>(range(gen));
+        d.radial_speed = static_cast<float>(speed(gen));
+        d.azimuth = static_cast<float>(azimuth(gen));
+        d.amplitude = static_cast<float>(amplitude(gen));
+        d.timestamp = timestamp;
+    }
+    return detections;
+}
+
+QByteArray encode(const std::vector<DetectionData>& detections, Encoding encoding)
+{
+    QByteArray datagram;
+    char line[192];
+
+    switch (encoding) {
+    case TextEncoding:
+        for (const auto& d : detections) {
+            int length = std::snprintf(line, sizeof(line),
+                                       "TgtId: %u Range: %.2f Speed: %.2f azimuth: %.2f amplitude: %.1f timestamp: %lld\n",
+                                       d.target_id, d.radius, d.radial_speed, d.azimuth, d.amplitude,
+                                       static_cast<long long>(d.timestamp));
+            datagram.append(line, length);
+        }
+        break;
+
+    case BinaryEncoding: {
+        DetectionFrameHeader_t header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, DETECTION_FRAME_MAGIC, sizeof(DETECTION_FRAME_MAGIC));
+        header.version = DETECTION_FRAME_VERSION;
+        header.header_size = sizeof(DetectionFrameHeader_t);
+        header.count = static_cast<uint16_t>(detections.size());
+        datagram.append(reinterpret_cast<const char*>(&header), sizeof(header));
+        for (const auto& d : detections) {
+            DetectionRecord_t record;
+            record.target_id = d.target_id;
+            record.radius = d.radius;
+            record.radial_speed = d.radial_speed;
+            record.azimuth = d.azimuth;
+            record.amplitude = d.amplitude;
+            record.timestamp = d.timestamp;
+            datagram.append(reinterpret_cast<const char*>(&record), sizeof(record));
+        }
+        break;
+    }
+    }
+    return datagram;
+}
+
+std::vector<QByteArray> datagramPool(int detectionsPerDatagram, Encoding encoding,
+                                     qint64 timestamp = QDateTime::currentMSecsSinceEpoch())
+{
+    std::mt19937 gen(42);
+    std::vector<QByteArray> pool;
+    pool.reserve(DATAGRAM_POOL);
+    for (int i = 0; i < DATAGRAM_POOL; ++i) {
+        pool.push_back(encode(syntheticDetections(detectionsPerDatagram, gen, timestamp), encoding));
+    }
+    return pool;
+}
+
+void reportThroughput(benchmark::State& state, int64_t detections, int64_t bytes)
+{
+    state.counters["detections/s"] = benchmark::Counter(static_cast<double>(detections),
+                                                        benchmark::Counter::kIsRate);
+    state.SetBytesProcessed(bytes);
+}
+
+// Fills the handler's store through the public ingest path
+void fillStore(UdpHandler& handler, int count, qint64 timestamp)
+{
+    std::mt19937 gen(7);
+    QByteArray frame = encode(syntheticDetections(qMin(count, 1000), gen, timestamp), BinaryEncoding);
+    for (int stored = 0; stored < count; stored += 1000) {
+        handler.ingestDatagram(frame.constData(), frame.size());
+    }
+    handler.flushIngestedDetections();
+}
+
+// Parsing
+
+template <Encoding encoding>
+void BM_Parse(benchmark::State& state)
+{
+    std::vector<QByteArray> pool = datagramPool(static_cast<int>(state.range(0)), encoding);
+    std::vector<DetectionData> out;
+    out.reserve(static_cast<size_t>(state.range(0)));
+
+    int64_t detections = 0;
+    int64_t bytes = 0;
+    size_t next = 0;
+    for (auto _ : state) {
+        const QByteArray& datagram = pool[next];
+        next = (next + 1) % pool.size();
+
+        out.clear();
+        UdpHandler::parseDetectionData(datagram, out);
+        benchmark::DoNotOptimize(out.data());
+
+        detections += static_cast<int64_t>(out.size());
+        bytes += datagram.size();
+    }
+    reportThroughput(state, detections, bytes);
+}
+BENCHMARK_TEMPLATE(BM_Parse, TextEncoding)->Arg(1)->Arg(8)->Arg(64);
+BENCHMARK_TEMPLATE(BM_Parse, BinaryEncoding)->Arg(1)->Arg(8)->Arg(64);
+
+// Detection store
+
+// Parse + addDetection with the store already holding maxDetections, so
+// every push also retires the oldest entry
+void BM_IngestSaturated(benchmark::State& state)
+{
+    UdpHandler handler;
+    int maxDetections = static_cast<int>(state.range(0));
+    handler.setMaxDetections(maxDetections);
+    fillStore(handler, maxDetections, QDateTime::currentMSecsSinceEpoch());
+
+    std::vector<QByteArray> pool = datagramPool(8, TextEncoding);
+    int64_t detections = 0;
+    int64_t bytes = 0;
+    size_t next = 0;
+    for (auto _ : state) {
+        const QByteArray& datagram = pool[next];
+        next = (next + 1) % pool.size();
+
+        handler.ingestDatagram(datagram.constData(), datagram.size());
+        detections += 8;
+        bytes += datagram.size();
+
+        // The GUI sees one batch per socket burst
+        if (next % 32 == 0) {
+            handler.flushIngestedDetections();
+        }
+    }
+    reportThroughput(state, detections, bytes);
+}
+BENCHMARK(BM_IngestSaturated)->Arg(1000)->Arg(10000)->Arg(100000);
+
+// Expiry with nothing to expire: the cost paid every 5 s in steady state
+void BM_CleanupNothingExpired(benchmark::State& state)
+{
+    UdpHandler handler;
+    int count = static_cast<int>(state.range(0));
+    handler.setMaxDetections(count);
+    handler.setDetectionTimeout(60000);
+    fillStore(handler, count, QDateTime::currentMSecsSinceEpoch());
+
+    for (auto _ : state) {
+        handler.expireOldDetections();
+    }
+    reportThroughput(state, state.iterations(), 0);
+}
+BENCHMARK(BM_CleanupNothingExpired)->Arg(1000)->Arg(100000);
+
+// Expiry of a full store
+void BM_CleanupAllExpired(benchmark::State& state)
+{
+    UdpHandler handler;
+    int count = static_cast<int>(state.range(0));
+    handler.setMaxDetections(count);
+    handler.setDetectionTimeout(1000);
+
+    int64_t detections = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        handler.clearDetections();
+        fillStore(handler, count, 0);
+        state.ResumeTiming();
+
+        handler.expireOldDetections();
+        detections += count;
+    }
+    reportThroughput(state, detections, detections * static_cast<int64_t>(sizeof(DetectionData)));
+}
+BENCHMARK(BM_CleanupAllExpired)->Arg(1000)->Arg(100000);
+
+// Snapshot copy the GUI takes on every refresh
+void BM_GetRecentDetections(benchmark::State& state)
+{
+    UdpHandler handler;
+    int count = static_cast<int>(state.range(0));
+    handler.setMaxDetections(count);
+    fillStore(handler, count, QDateTime::currentMSecsSinceEpoch());
+
+    int64_t detections = 0;
+    for (auto _ : state) {
+        std::vector<DetectionData> snapshot = handler.getRecentDetections();
+        benchmark::DoNotOptimize(snapshot.data());
+        detections += static_cast<int64_t>(snapshot.size());
+    }
+    reportThroughput(state, detections, detections * static_cast<int64_t>(sizeof(DetectionData)));
+}
+BENCHMARK(BM_GetRecentDetections)->Arg(100)->Arg(1000)->Arg(10000)->Arg(100000);
+
+// DSP settings
+
+void BM_DspSettingsChecksum(benchmark::State& state)
+{
+    DSP_Settings_t settings;
+
+    int64_t packets = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(&settings);
+        uint16_t crc = settings.calculateChecksum();
+        benchmark::DoNotOptimize(crc);
+        packets++;
+    }
+    // No detections here; detections/s counts checksummed packets
+    reportThroughput(state, packets, packets * static_cast<int64_t>(sizeof(DSP_Settings_t)));
+}
+BENCHMARK(BM_DspSettingsChecksum);
+
+// CRC16 engines over typical buffer sizes: one DSP settings packet, a
+// 64-record detection frame (16 + 64 * 28 bytes) and a capture-sized block
+
+enum CrcEngine {
+    BitwiseCrc,
+    BytewiseCrc,
+    SliceBy8Crc
+};
+
+template <CrcEngine engine>
+void BM_Crc16(benchmark::State& state)
+{
+    std::vector<uint8_t> buffer(static_cast<size_t>(state.range(0)));
+    std::mt19937 gen(3);
+    for (auto& byte : buffer) {
+        byte = static_cast<uint8_t>(gen());
+    }
+
+    // All engines must agree before any of them is timed
+    uint16_t reference = Crc16::bitwise(buffer.data(), buffer.size());
+    if (Crc16::bytewise(buffer.data(), buffer.size()) != reference ||
+        Crc16::compute(buffer.data(), buffer.size()) != reference) {
+        state.SkipWithError("CRC16 engines disagree");
+        return;
+    }
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(buffer.data());
+        uint16_t crc = 0;
+        switch (engine) {
+        case BitwiseCrc:  crc = Crc16::bitwise(buffer.data(), buffer.size()); break;
+        case BytewiseCrc: crc = Crc16::bytewise(buffer.data(), buffer.size()); break;
+        case SliceBy8Crc: crc = Crc16::compute(buffer.data(), buffer.size()); break;
+        }
+        benchmark::DoNotOptimize(crc);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_Crc16, BitwiseCrc)->Arg(sizeof(DSP_Settings_t))->Arg(1808)->Arg(65536);
+BENCHMARK_TEMPLATE(BM_Crc16, BytewiseCrc)->Arg(sizeof(DSP_Settings_t))->Arg(1808)->Arg(65536);
+BENCHMARK_TEMPLATE(BM_Crc16, SliceBy8Crc)->Arg(sizeof(DSP_Settings_t))->Arg(1808)->Arg(65536);
+
+// Track updates: one detection per live track per 50 ms radar frame, with
+// and without the Kalman filter (second argument)
+
+void BM_TrackStoreUpdate(benchmark::State& state)
+{
+    int trackCount = static_cast<int>(state.range(0));
+    std::mt19937 gen(11);
+    std::vector<DetectionData> frame = syntheticDetections(trackCount, gen, 0);   // IDs 1..trackCount
+
+    TrackStore store(trackCount);
+    store.setFilteringEnabled(state.range(1) != 0);
+
+    qint64 frameTimeUs = 1000000;
+    int64_t detections = 0;
+    for (auto _ : state) {
+        for (auto& detection : frame) {
+            detection.receive_time_us = frameTimeUs;
+        }
+        store.updateBatch(frame, frameTimeUs / 1000);
+        frameTimeUs += 50000;
+        detections += trackCount;
+    }
+    benchmark::DoNotOptimize(store.at(0).latest);
+    reportThroughput(state, detections, detections * static_cast<int64_t>(sizeof(DetectionData)));
+}
+BENCHMARK(BM_TrackStoreUpdate)->Args({ 500, 0 })->Args({ 500, 1 })->Args({ 5000, 0 })->Args({ 5000, 1 });
+
+// ID association: N targets moving through a 100 m / +-60 degree field of
+// view, reported every 50 ms with measurement noise, shuffled and with
+// meaningless sensor IDs. One iteration associates one frame.
+
+void BM_Associate(benchmark::State& state)
+{
+    const int targetCount = static_cast<int>(state.range(0));
+    const int FRAME_COUNT = 256;
+    const qint64 FRAME_INTERVAL_US = 50000;
+
+    std::mt19937 gen(13);
+    std::uniform_real_distribution<> range(5.0, 100.0);
+    std::uniform_real_distribution<> azimuth(-60.0, 60.0);
+    std::uniform_real_distribution<> speed(-15.0, 15.0);
+    std::uniform_real_distribution<> azimuthRate(-5.0, 5.0);
+    std::normal_distribution<> rangeNoise(0.0, 0.2);
+    std::normal_distribution<> azimuthNoise(0.0, 0.5);
+    std::normal_distribution<> speedNoise(0.0, 0.2);
+
+    struct Target { double range, azimuth, speed, azimuthRate; };
+    std::vector<Target> targets(targetCount);
+    for (auto& target : targets) {
+        target = { range(gen), azimuth(gen), speed(gen), azimuthRate(gen) };
+    }
+
+    std::vector<std::vector<DetectionData>> frames(FRAME_COUNT, std::vector<DetectionData>(targetCount));
+    std::vector<int> order(targetCount);
+    for (int i = 0; i < targetCount; ++i) {
+        order[i] = i;
+    }
+    for (auto& frame : frames) {
+        double dt = FRAME_INTERVAL_US / 1e6;
+        for (auto& target : targets) {
+            target.range -= target.speed * dt;
+            target.azimuth += target.azimuthRate * dt;
+            if (target.range < 2.0 || target.range > 110.0 || std::abs(target.azimuth) > 80.0) {
+                target = { range(gen), azimuth(gen), speed(gen), azimuthRate(gen) };
+            }
+        }
+        std::shuffle(order.begin(), order.end(), gen);
+        for (int i = 0; i < targetCount; ++i) {
+            const Target& target = targets[order[i]];
+            DetectionData& detection = frame[i];
+            detection.target_id = static_cast<uint32_t>(i + 1);
+            detection.radius = static_cast<float>(target.range + rangeNoise(gen));
+            detection.azimuth = static_cast<float>(target.azimuth + azimuthNoise(gen));
+            detection.radial_speed = static_cast<float>(target.speed + speedNoise(gen));
+        }
+    }
+
+    TrackAssociator associator;
+    std::vector<DetectionData> scratch(targetCount);
+    qint64 timeUs = 1000000;
+    int frameIndex = 0;
+    int64_t detections = 0;
+    for (auto _ : state) {
+        if (frameIndex == FRAME_COUNT) {
+            // The scene jumps back to the start; begin with empty tracks
+            state.PauseTiming();
+            associator.reset();
+            frameIndex = 0;
+            state.ResumeTiming();
+        }
+        std::copy(frames[frameIndex].begin(), frames[frameIndex].end(), scratch.begin());
+        associator.associate(scratch.data(), scratch.size(), timeUs);
+        benchmark::DoNotOptimize(scratch.data());
+        timeUs += FRAME_INTERVAL_US;
+        frameIndex++;
+        detections += targetCount;
+    }
+
+    const TrackAssociator::Statistics& stats = associator.statistics();
+    if (stats.detections > 0) {
+        state.counters["direct%"] = 100.0 * stats.directAssignments / stats.detections;
+        state.counters["solved%"] = 100.0 * stats.solvedAssignments / stats.detections;
+        state.counters["new%"] = 100.0 * stats.newTracks / stats.detections;
+    }
+    reportThroughput(state, detections, detections * static_cast<int64_t>(sizeof(DetectionData)));
+}
+BENCHMARK(BM_Associate)->Arg(50)->Arg(500)->Arg(2000);
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    // UdpHandler owns timers and needs an application object
+    QCoreApplication app(argc, argv);
+
+    // addDetection() logs every detection in debug builds; keep that off the terminal
+    RadarLog::setOutputFile(QProcess::nullDevice());
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,188 @@
+// Offscreen render benchmark for CustomChart.
+//
+// Renders every chart type, and the detection chart's afterglow mode, into
+// a QImage through the offscreen platform plugin, at several widget sizes
+// and data sizes, and reports per-frame time percentiles against a 16 ms
+// frame budget.
+//
+// Usage: render_bench [frames] [device pixel ratio]
+// The data size is the number of detections for the detection chart and
+// the number of samples (bins for the histogram) for the other types.
+// Data is replaced before every frame, like a live feed; that copy is not
+// part of the measured time.
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QImage>
+#include <QSize>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "../customchart.h"
+
+namespace {
+
+const double FRAME_BUDGET_MS = 16.0;
+const int WARMUP_FRAMES = 5;
+
+struct BenchCase {
+    const char* name;
+    CustomChart::ChartType type;
+    CustomChart::DetectionDisplayMode displayMode;
+};
+
+class FrameData
+{
+public:
+    FrameData() : gen(42) {}
+
+    void apply(CustomChart& chart, CustomChart::ChartType type, int count)
+    {
+        switch (type) {
+        case CustomChart::DETECTION_CHART:
+            // One track per marker: the chart keeps the latest detection per target_id
+            detections.resize(count);
+            for (int i = 0; i < count; ++i) {
+                TargetDetection& detection = detections[i];
+                detection.target_id = static_cast<uint32_t>(i + 1);
+                detection.radius = static_cast<float>(range(gen));
+                detection.radial_speed = static_cast<float>(speed(gen));
+                detection.azimuth = static_cast<float>(azimuth(gen));
+                detection.amplitude = static_cast<float>(amplitude(gen));
+            }
+            chart.setDetections(detections);
+            break;
+
+        case CustomChart::FFT_CHART:
+            fillSeries(count, 0.0, 100.0);
+            chart.setFFTData(series);
+            break;
+
+        case CustomChart::RAW_SIGNAL_CHART:
+            fillSeries(count, -1.0, 1.0);
+            chart.setRawSignalData(series);
+            break;
+
+        case CustomChart::HISTOGRAM_CHART:
+            fillSeries(count, 0.0, 50.0);
+            chart.setHistogramData(series);
+            break;
+        }
+    }
+
+private:
+    std::mt19937 gen;
+    std::uniform_real_distribution<> range{0.5, 100.0};
+    std::uniform_real_distribution<> speed{-30.0, 30.0};
+    std::uniform_real_distribution<> azimuth{-60.0, 60.0};
+    std::uniform_real_distribution<> amplitude{0.0, 60.0};
+    std::vector<TargetDetection> detections;
+    std::vector<double> series;
+
+    void fillSeries(int count, double low, double high)
+    {
+        std::uniform_real_distribution<> value(low, high);
+        series.resize(count);
+        for (auto& sample : series) {
+            sample = value(gen);
+        }
+    }
+};
+
+double percentile(const std::vector<double>& sorted, double p)
+{
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    size_t index = static_cast<size_t>(std::ceil(p / 100.0 * sorted.size()));
+    return sorted[std::min(sorted.size(), std::max<size_t>(index, 1)) - 1];
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    // No display needed; an explicit QT_QPA_PLATFORM still wins
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+
+    int frames = argc > 1 ? qMax(1, QString(argv[1]).toInt()) : 200;
+    qreal dpr = argc > 2 ? qMax(1.0, QString(argv[2]).toDouble()) : 1.0;
+
+    const BenchCase cases[] = {
+        { "FFT",        CustomChart::FFT_CHART,        CustomChart::TrackDisplay },
+        { "RAW_SIGNAL", CustomChart::RAW_SIGNAL_CHART, CustomChart::TrackDisplay },
+        { "DETECTION",  CustomChart::DETECTION_CHART,  CustomChart::TrackDisplay },
+        { "AFTERGLOW",  CustomChart::DETECTION_CHART,  CustomChart::PersistenceDisplay },
+        { "HISTOGRAM",  CustomChart::HISTOGRAM_CHART,  CustomChart::TrackDisplay }
+    };
+    const QSize sizes[] = { QSize(640, 480), QSize(1280, 720), QSize(1920, 1080) };
+    const int counts[] = { 10, 100, 1000, 10000 };
+
+    std::printf("%d frames per case, device pixel ratio %.1f, budget %.0f ms\n\n", frames, dpr, FRAME_BUDGET_MS);
+    std::printf("%-11s %-10s %6s %8s %8s %8s %8s %8s  %s\n",
+                "chart", "size", "count", "p50 ms", "p90 ms", "p99 ms", "max ms", "mean ms", "over budget");
+
+    int casesOverBudget = 0;
+    for (const BenchCase& benchCase : cases) {
+        CustomChart::ChartType type = benchCase.type;
+        for (const QSize& size : sizes) {
+            for (int count : counts) {
+                CustomChart chart(type);
+                chart.setFrozen(true);
+                chart.setDetectionDisplayMode(benchCase.displayMode);
+                chart.setMaxDataPoints(count);
+                chart.resize(size);
+
+                QImage image(size * dpr, QImage::Format_ARGB32_Premultiplied);
+                image.setDevicePixelRatio(dpr);
+
+                FrameData data;
+                std::vector<double> times;
+                times.reserve(frames);
+
+                // Warm-up frames build the static layer caches and marker atlas
+                for (int frame = -WARMUP_FRAMES; frame < frames; ++frame) {
+                    data.apply(chart, type, count);
+
+                    QElapsedTimer timer;
+                    timer.start();
+                    chart.render(&image);
+                    double ms = timer.nsecsElapsed() / 1e6;
+
+                    if (frame >= 0) {
+                        times.push_back(ms);
+                    }
+                }
+
+                std::sort(times.begin(), times.end());
+                double mean = 0.0;
+                for (double t : times) {
+                    mean += t;
+                }
+                mean /= times.size();
+                size_t overBudget = static_cast<size_t>(
+                    times.end() - std::upper_bound(times.begin(), times.end(), FRAME_BUDGET_MS));
+
+                double p99 = percentile(times, 99);
+                if (p99 > FRAME_BUDGET_MS) {
+                    casesOverBudget++;
+                }
+
+                std::printf("%-11s %4dx%-5d %6d %8.2f %8.2f %8.2f %8.2f %8.2f  %zu/%zu%s\n",
+                            benchCase.name, size.width(), size.height(), count,
+                            percentile(times, 50), percentile(times, 90), p99,
+                            times.back(), mean, overBudget, times.size(),
+                            p99 > FRAME_BUDGET_MS ? "  !" : "");
+                std::fflush(stdout);
+            }
+        }
+    }
+
+    std::printf("\n%d case(s) with p99 over the %.0f ms budget\n", casesOverBudget, FRAME_BUDGET_MS);
+    return 0;
+}
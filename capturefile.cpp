@@ -0,0 +1,271 @@
+#include "capturefile.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QRegularExpression>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <limits>
+
+namespace {
+
+// "<name>_<4 digits>.rcap"
+const QRegularExpression& segmentSuffix()
+{
+    static const QRegularExpression pattern("^(.*)_(\\d{4})\\.rcap$");
+    return pattern;
+}
+
+} // namespace
+
+qint64 CaptureFile::nowUs()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+QString CaptureFile::segmentPath(const QString& basePath, uint32_t index)
+{
+    QFileInfo info(basePath);
+    QString name = info.fileName();
+    if (name.endsWith(".rcap")) {
+        name.chop(5);
+    }
+    return info.dir().filePath(QString("%1_%2.rcap").arg(name).arg(index, 4, 10, QChar('0')));
+}
+
+QStringList CaptureFile::sessionSegments(const QString& path)
+{
+    QFileInfo info(path);
+    QString name = info.fileName();
+
+    QRegularExpressionMatch match = segmentSuffix().match(name);
+    if (match.hasMatch()) {
+        name = match.captured(1);
+    } else if (name.endsWith(".rcap")) {
+        name.chop(5);
+    }
+
+    // Segments are numbered consecutively; stop at the first gap
+    QStringList segments;
+    for (uint32_t index = 0;; ++index) {
+        QString segment = segmentPath(info.dir().filePath(name), index);
+        if (!QFileInfo::exists(segment)) {
+            break;
+        }
+        segments << segment;
+    }
+
+    // A single capture file that does not follow the naming scheme
+    if (segments.isEmpty() && info.exists()) {
+        segments << path;
+    }
+    return segments;
+}
+
+// CaptureReader Implementation
+CaptureReader::CaptureReader()
+    : mapped(nullptr)
+    , mappedSize(0)
+    , dataStart(0)
+    , dataEnd(0)
+    , offset(0)
+    , lastRecordTimeUs(0)
+    , storedIndex(false)
+{
+    std::memset(&header, 0, sizeof(header));
+}
+
+CaptureReader::~CaptureReader()
+{
+    close();
+}
+
+bool CaptureReader::open(const QString& path, QString* error)
+{
+    close();
+
+    file.setFileName(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error) {
+            *error = file.errorString();
+        }
+        return false;
+    }
+
+    mappedSize = file.size();
+    if (mappedSize < static_cast<qint64>(sizeof(CaptureFileHeader_t))) {
+        if (error) {
+            *error = QString("%1 is not a capture file").arg(path);
+        }
+        file.close();
+        return false;
+    }
+
+    // The whole segment is mapped; records are read straight out of the page cache
+    mapped = file.map(0, mappedSize);
+    if (!mapped) {
+        if (error) {
+            *error = file.errorString();
+        }
+        file.close();
+        return false;
+    }
+
+    std::memcpy(&header, mapped, sizeof(header));
+    if (std::memcmp(header.magic, CAPTURE_FILE_MAGIC, sizeof(CAPTURE_FILE_MAGIC)) != 0 ||
+        header.version != CAPTURE_FILE_VERSION ||
+        header.header_size < sizeof(CaptureFileHeader_t) ||
+        header.header_size > mappedSize) {
+        if (error) {
+            *error = QString("%1 is not a supported capture file").arg(path);
+        }
+        close();
+        return false;
+    }
+
+    dataStart = header.header_size;
+    dataEnd = mappedSize;
+
+    storedIndex = loadStoredIndex();
+    if (!storedIndex) {
+        rebuildIndex();
+    }
+
+    offset = dataStart;
+    return true;
+}
+
+bool CaptureReader::loadStoredIndex()
+{
+    qint64 trailerOffset = mappedSize - static_cast<qint64>(sizeof(CaptureIndexTrailer_t));
+    if (trailerOffset < dataStart) {
+        return false;
+    }
+
+    CaptureIndexTrailer_t trailer;
+    std::memcpy(&trailer, mapped + trailerOffset, sizeof(trailer));
+    if (std::memcmp(trailer.magic, CAPTURE_INDEX_MAGIC, sizeof(CAPTURE_INDEX_MAGIC)) != 0 ||
+        trailer.index_offset < dataStart || trailer.index_offset > trailerOffset ||
+        trailer.index_offset + static_cast<qint64>(trailer.entry_count) * static_cast<qint64>(sizeof(CaptureIndexEntry_t)) != trailerOffset) {
+        return false;
+    }
+
+    timeIndex.resize(trailer.entry_count);
+    if (trailer.entry_count > 0) {
+        std::memcpy(timeIndex.data(), mapped + trailer.index_offset,
+                    trailer.entry_count * sizeof(CaptureIndexEntry_t));
+    }
+
+    // seekToTime() trusts every offset and binary-searches the times, so a
+    // damaged footer falls back to a rescan
+    qint64 previousTimeUs = std::numeric_limits<qint64>::min();
+    for (const CaptureIndexEntry_t& entry : timeIndex) {
+        if (entry.offset < dataStart || entry.offset >= trailer.index_offset ||
+            entry.receive_time_us < previousTimeUs) {
+            timeIndex.clear();
+            return false;
+        }
+        previousTimeUs = entry.receive_time_us;
+    }
+    dataEnd = trailer.index_offset;
+
+    // The newest record lies after the last entry; only that stretch is scanned
+    lastRecordTimeUs = 0;
+    offset = timeIndex.empty() ? dataStart : timeIndex.back().offset;
+    CaptureRecord record;
+    while (next(record)) {
+        lastRecordTimeUs = record.receiveTimeUs;
+    }
+    return true;
+}
+
+void CaptureReader::rebuildIndex()
+{
+    // Same spacing the recorder uses, so seeks cost the same either way
+    const qint64 intervalUs = static_cast<qint64>(CAPTURE_INDEX_INTERVAL_MS) * 1000;
+
+    timeIndex.clear();
+    lastRecordTimeUs = 0;
+    offset = dataStart;
+
+    CaptureRecord record;
+    qint64 recordOffset = offset;
+    while (next(record)) {
+        if (timeIndex.empty() || record.receiveTimeUs >= timeIndex.back().receive_time_us + intervalUs) {
+            CaptureIndexEntry_t entry;
+            entry.receive_time_us = record.receiveTimeUs;
+            entry.offset = recordOffset;
+            timeIndex.push_back(entry);
+        }
+        lastRecordTimeUs = record.receiveTimeUs;
+        recordOffset = offset;
+    }
+}
+
+bool CaptureReader::seekToTime(qint64 timeUs)
+{
+    if (!mapped) {
+        return false;
+    }
+
+    // Last entry at or before timeUs, then a short scan to the exact record
+    auto entry = std::upper_bound(timeIndex.begin(), timeIndex.end(), timeUs,
+                                  [](qint64 time, const CaptureIndexEntry_t& e) { return time < e.receive_time_us; });
+    offset = entry == timeIndex.begin() ? dataStart : std::prev(entry)->offset;
+
+    CaptureRecord record;
+    qint64 recordOffset = offset;
+    while (next(record)) {
+        if (record.receiveTimeUs >= timeUs) {
+            offset = recordOffset;
+            return true;
+        }
+        recordOffset = offset;
+    }
+    return false;
+}
+
+void CaptureReader::close()
+{
+    if (mapped) {
+        file.unmap(const_cast<uchar*>(mapped));
+        mapped = nullptr;
+    }
+    if (file.isOpen()) {
+        file.close();
+    }
+    mappedSize = 0;
+    dataStart = 0;
+    dataEnd = 0;
+    offset = 0;
+    timeIndex.clear();
+    lastRecordTimeUs = 0;
+    storedIndex = false;
+}
+
+bool CaptureReader::next(CaptureRecord& record)
+{
+    if (!mapped || dataEnd - offset < static_cast<qint64>(sizeof(CaptureRecordHeader_t))) {
+        return false;
+    }
+
+    CaptureRecordHeader_t recordHeader;
+    std::memcpy(&recordHeader, mapped + offset, sizeof(recordHeader));
+
+    qint64 payloadStart = offset + sizeof(CaptureRecordHeader_t);
+    if (recordHeader.length > dataEnd - payloadStart) {
+        return false;
+    }
+
+    record.receiveTimeUs = recordHeader.receive_time_us;
+    record.data = reinterpret_cast<const char*>(mapped + payloadStart);
+    record.size = static_cast<int>(recordHeader.length);
+    offset = payloadStart + recordHeader.length;
+    return true;
+}
+
+void CaptureReader::rewind()
+{
+    offset = dataStart;
+}
@@ -0,0 +1,132 @@
+#ifndef CAPTUREFILE_H
+#define CAPTUREFILE_H
+
+#include <QFile>
+#include <QString>
+#include <QStringList>
+#include <cstdint>
+#include <vector>
+
+// On-disk layout of a raw UDP capture segment. Little-endian:
+//   CaptureFileHeader_t, then records of CaptureRecordHeader_t + `length`
+//   datagram bytes, back to back, then the time index footer:
+//   `entry_count` CaptureIndexEntry_t followed by CaptureIndexTrailer_t.
+// The footer is written when the segment is closed; a segment without one
+// (recorder killed) is still readable and its index is rebuilt by a scan.
+// A session is split into segments named <base>_0000.rcap, <base>_0001.rcap, ...
+#pragma pack(push, 1)
+struct CaptureFileHeader_t {
+    char magic[4];                     // "RCAP"
+    uint16_t version;                  // File format version (currently 1)
+    uint16_t header_size;              // Size of this header, lets later versions append fields
+    uint32_t segment_index;            // Position of this segment within the session
+    uint32_t reserved;                 // Reserved for alignment
+    int64_t created_us;                // Wall clock at segment creation, us since epoch
+};
+
+struct CaptureRecordHeader_t {
+    int64_t receive_time_us;           // Wall clock when the datagram arrived, us since epoch
+    uint32_t length;                   // Number of datagram bytes following this header
+};
+
+struct CaptureIndexEntry_t {
+    int64_t receive_time_us;           // Receive time of the indexed record
+    int64_t offset;                    // Byte offset of that record within the segment
+};
+
+struct CaptureIndexTrailer_t {
+    char magic[4];                     // "RIDX"
+    uint32_t entry_count;              // Number of CaptureIndexEntry_t before this trailer
+    int64_t index_offset;              // Byte offset of the first entry, i.e. end of the records
+    uint32_t interval_ms;              // Minimum spacing of the entries in receive time
+    uint32_t reserved;                 // Reserved for alignment
+};
+#pragma pack(pop)
+
+static constexpr char CAPTURE_FILE_MAGIC[4] = { 'R', 'C', 'A', 'P' };
+static constexpr uint16_t CAPTURE_FILE_VERSION = 1;
+static_assert(sizeof(CaptureFileHeader_t) == 24, "Capture header layout changed");
+static_assert(sizeof(CaptureRecordHeader_t) == 12, "Capture record layout changed");
+
+static constexpr char CAPTURE_INDEX_MAGIC[4] = { 'R', 'I', 'D', 'X' };
+static constexpr uint32_t CAPTURE_INDEX_INTERVAL_MS = 100;
+static_assert(sizeof(CaptureIndexEntry_t) == 16, "Capture index entry layout changed");
+static_assert(sizeof(CaptureIndexTrailer_t) == 24, "Capture index trailer layout changed");
+
+namespace CaptureFile {
+
+// Wall clock in microseconds since epoch, the capture time base
+qint64 nowUs();
+
+// <dir>/<name>_<index>.rcap for the session whose first file is basePath
+QString segmentPath(const QString& basePath, uint32_t index);
+
+// All segments of the session that path belongs to, in order. Accepts the
+// base path given to the recorder or any one of its segment files.
+QStringList sessionSegments(const QString& path);
+
+} // namespace CaptureFile
+
+// One recorded datagram. data points into the mapped file and stays valid
+// until the reader is closed.
+struct CaptureRecord {
+    qint64 receiveTimeUs;
+    const char* data;
+    int size;
+};
+
+// Sequential reader over one memory-mapped capture segment, with
+// O(log n) seeking by receive time through the segment's time index
+class CaptureReader
+{
+public:
+    CaptureReader();
+    ~CaptureReader();
+
+    CaptureReader(const CaptureReader&) = delete;
+    CaptureReader& operator=(const CaptureReader&) = delete;
+
+    bool open(const QString& path, QString* error);
+    void close();
+    bool isOpen() const { return mapped != nullptr; }
+
+    // Returns the record at the current position and advances past it.
+    // Returns false at the end of the data, including a record cut short
+    // because the recorder was stopped mid-write.
+    bool next(CaptureRecord& record);
+
+    // Byte offsets of records within the segment
+    qint64 position() const { return offset; }
+    void rewind();
+    void seekToEnd() { offset = dataEnd; }
+
+    // Positions the reader on the first record received at or after timeUs.
+    // Returns false if every record is older.
+    bool seekToTime(qint64 timeUs);
+
+    // Receive time range covered by the segment, 0 if it holds no records
+    qint64 firstTimeUs() const { return timeIndex.empty() ? 0 : timeIndex.front().receive_time_us; }
+    qint64 lastTimeUs() const { return lastRecordTimeUs; }
+    bool hasStoredIndex() const { return storedIndex; }
+
+    uint32_t segmentIndex() const { return header.segment_index; }
+    qint64 createdUs() const { return header.created_us; }
+
+private:
+    QFile file;
+    const uchar* mapped;
+    qint64 mappedSize;
+    qint64 dataStart;
+    qint64 dataEnd;
+    qint64 offset;
+    CaptureFileHeader_t header;
+
+    std::vector<CaptureIndexEntry_t> timeIndex;
+    qint64 lastRecordTimeUs;
+    bool storedIndex;
+
+    bool loadStoredIndex();
+    void rebuildIndex();
+};
+
+#endif // CAPTUREFILE_H
@@ -0,0 +1,283 @@
+#include "capturerecorder.h"
+#include <QMutexLocker>
+#include <cstring>
+
+CaptureRecorder::CaptureRecorder(QObject* parent)
+    : QObject(parent)
+    , stopRequested(false)
+    , segmentIndex(0)
+    , segmentBytes(0)
+    , segmentSizeLimit(DEFAULT_SEGMENT_BYTES)
+    , recording(false)
+    , datagramsRecorded(0)
+    , datagramsDropped(0)
+    , bytesWritten(0)
+{
+}
+
+CaptureRecorder::~CaptureRecorder()
+{
+    stop();
+}
+
+bool CaptureRecorder::start(const QString& path, QString* error)
+{
+    stop();
+
+    basePath = path;
+    segmentIndex = 0;
+    datagramsRecorded = 0;
+    datagramsDropped = 0;
+    bytesWritten = 0;
+
+    // Open the first segment here so a bad path is reported to the caller
+    if (!openSegment(error)) {
+        return false;
+    }
+
+    {
+        QMutexLocker locker(&mutex);
+        stopRequested = false;
+        activeBuffer = takeFreeBuffer();
+    }
+
+    writerThread.reset(QThread::create([this]() { writerLoop(); }));
+    writerThread->setObjectName("CaptureWriter");
+    writerThread->start(QThread::LowPriority);
+
+    recording.store(true, std::memory_order_release);
+    return true;
+}
+
+void CaptureRecorder::stop()
+{
+    if (!writerThread) {
+        return;
+    }
+
+    recording.store(false, std::memory_order_release);
+    {
+        QMutexLocker locker(&mutex);
+        stopRequested = true;
+        buffersReady.wakeOne();
+    }
+
+    // The writer drains everything queued before it exits
+    writerThread->wait();
+    writerThread.reset();
+
+    // A segment whose index could not be written is still readable; the reader rebuilds the index
+    closeSegment(nullptr);
+}
+
+void CaptureRecorder::append(const char* data, int size, qint64 receiveTimeUs)
+{
+    if (!isRecording() || size < 0) {
+        return;
+    }
+
+    CaptureRecordHeader_t header;
+    header.receive_time_us = receiveTimeUs;
+    header.length = static_cast<uint32_t>(size);
+    size_t recordSize = sizeof(header) + static_cast<size_t>(size);
+
+    QMutexLocker locker(&mutex);
+    if (stopRequested) {
+        return;
+    }
+
+    if (activeBuffer.size() + recordSize > BUFFER_BYTES && !activeBuffer.empty()) {
+        if (!queueActiveBuffer()) {
+            datagramsDropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+
+    size_t position = activeBuffer.size();
+    activeBuffer.resize(position + recordSize);
+    std::memcpy(activeBuffer.data() + position, &header, sizeof(header));
+    std::memcpy(activeBuffer.data() + position + sizeof(header), data, static_cast<size_t>(size));
+    datagramsRecorded.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool CaptureRecorder::queueActiveBuffer()
+{
+    // Called with mutex held
+    if (fullBuffers.size() >= MAX_QUEUED_BUFFERS) {
+        return false;
+    }
+
+    fullBuffers.push_back(std::move(activeBuffer));
+    activeBuffer = takeFreeBuffer();
+    buffersReady.wakeOne();
+    return true;
+}
+
+std::vector<char> CaptureRecorder::takeFreeBuffer()
+{
+    // Called with mutex held; buffers are recycled so steady-state recording does not allocate
+    std::vector<char> buffer;
+    if (!freeBuffers.empty()) {
+        buffer = std::move(freeBuffers.back());
+        freeBuffers.pop_back();
+    } else {
+        buffer.reserve(BUFFER_BYTES);
+    }
+    buffer.clear();
+    return buffer;
+}
+
+void CaptureRecorder::writerLoop()
+{
+    QMutexLocker locker(&mutex);
+
+    while (true) {
+        if (fullBuffers.empty() && !stopRequested) {
+            buffersReady.wait(&mutex, FLUSH_INTERVAL_MS);
+        }
+
+        // On timeout or stop, write whatever has accumulated so far
+        if (fullBuffers.empty() && !activeBuffer.empty()) {
+            fullBuffers.push_back(std::move(activeBuffer));
+            activeBuffer = takeFreeBuffer();
+        }
+
+        if (fullBuffers.empty()) {
+            if (stopRequested) {
+                break;
+            }
+            continue;
+        }
+
+        std::vector<char> buffer = std::move(fullBuffers.front());
+        fullBuffers.pop_front();
+
+        locker.unlock();
+        QString error;
+        bool written = writeBuffer(buffer, &error);
+        locker.relock();
+
+        buffer.clear();
+        freeBuffers.push_back(std::move(buffer));
+
+        if (!written) {
+            recording.store(false, std::memory_order_release);
+            fullBuffers.clear();
+            activeBuffer.clear();
+            emit errorOccurred(QString("Capture recording stopped: %1").arg(error));
+            break;
+        }
+    }
+}
+
+bool CaptureRecorder::writeBuffer(const std::vector<char>& buffer, QString* error)
+{
+    // Buffers hold whole records, so segments are only ever split between records
+    if (segmentBytes > static_cast<qint64>(sizeof(CaptureFileHeader_t)) &&
+        segmentBytes + static_cast<qint64>(buffer.size()) > segmentSizeLimit) {
+        if (!closeSegment(error)) {
+            return false;
+        }
+        segmentIndex++;
+        if (!openSegment(error)) {
+            return false;
+        }
+    }
+
+    indexBuffer(buffer);
+
+    const char* data = buffer.data();
+    qint64 remaining = static_cast<qint64>(buffer.size());
+    while (remaining > 0) {
+        qint64 written = segmentFile.write(data, remaining);
+        if (written <= 0) {
+            if (error) {
+                *error = segmentFile.errorString();
+            }
+            return false;
+        }
+        data += written;
+        remaining -= written;
+    }
+
+    segmentBytes += static_cast<qint64>(buffer.size());
+    bytesWritten.fetch_add(buffer.size(), std::memory_order_relaxed);
+    return true;
+}
+
+bool CaptureRecorder::openSegment(QString* error)
+{
+    // Buffering happens in our own large buffers, so skip QFile's
+    segmentFile.setFileName(CaptureFile::segmentPath(basePath, segmentIndex));
+    if (!segmentFile.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Unbuffered)) {
+        if (error) {
+            *error = segmentFile.errorString();
+        }
+        return false;
+    }
+
+    CaptureFileHeader_t header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, CAPTURE_FILE_MAGIC, sizeof(CAPTURE_FILE_MAGIC));
+    header.version = CAPTURE_FILE_VERSION;
+    header.header_size = sizeof(CaptureFileHeader_t);
+    header.segment_index = segmentIndex;
+    header.created_us = CaptureFile::nowUs();
+
+    if (segmentFile.write(reinterpret_cast<const char*>(&header), sizeof(header)) != sizeof(header)) {
+        if (error) {
+            *error = segmentFile.errorString();
+        }
+        segmentFile.close();
+        return false;
+    }
+
+    segmentBytes = sizeof(header);
+    timeIndex.clear();
+    return true;
+}
+
+void CaptureRecorder::indexBuffer(const std::vector<char>& buffer)
+{
+    // Walk the record headers of a buffer about to be written at segmentBytes
+    const qint64 intervalUs = static_cast<qint64>(CAPTURE_INDEX_INTERVAL_MS) * 1000;
+    size_t position = 0;
+    while (position + sizeof(CaptureRecordHeader_t) <= buffer.size()) {
+        CaptureRecordHeader_t header;
+        std::memcpy(&header, buffer.data() + position, sizeof(header));
+
+        if (timeIndex.empty() || header.receive_time_us >= timeIndex.back().receive_time_us + intervalUs) {
+            CaptureIndexEntry_t entry;
+            entry.receive_time_us = header.receive_time_us;
+            entry.offset = segmentBytes + static_cast<qint64>(position);
+            timeIndex.push_back(entry);
+        }
+
+        position += sizeof(header) + header.length;
+    }
+}
+
+bool CaptureRecorder::closeSegment(QString* error)
+{
+    if (!segmentFile.isOpen()) {
+        return true;
+    }
+
+    CaptureIndexTrailer_t trailer;
+    std::memset(&trailer, 0, sizeof(trailer));
+    std::memcpy(trailer.magic, CAPTURE_INDEX_MAGIC, sizeof(CAPTURE_INDEX_MAGIC));
+    trailer.entry_count = static_cast<uint32_t>(timeIndex.size());
+    trailer.index_offset = segmentBytes;
+    trailer.interval_ms = CAPTURE_INDEX_INTERVAL_MS;
+
+    qint64 indexBytes = static_cast<qint64>(timeIndex.size() * sizeof(CaptureIndexEntry_t));
+    bool written = segmentFile.write(reinterpret_cast<const char*>(timeIndex.data()), indexBytes) == indexBytes &&
+                   segmentFile.write(reinterpret_cast<const char*>(&trailer), sizeof(trailer)) == sizeof(trailer);
+    if (!written && error) {
+        *error = segmentFile.errorString();
+    }
+
+    segmentFile.close();
+    timeIndex.clear();
+    return written;
+}
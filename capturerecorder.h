@@ -0,0 +1,89 @@
+#ifndef CAPTURERECORDER_H
+#define CAPTURERECORDER_H
+
+#include <QObject>
+#include <QFile>
+#include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <vector>
+#include "capturefile.h"
+
+// Appends every raw datagram, with its receive time, to a segmented capture
+// file (see capturefile.h). Each segment ends with a sparse time index,
+// one entry per CAPTURE_INDEX_INTERVAL_MS of receive time, so replay can
+// seek without scanning.
+//
+// append() only copies the datagram into an in-memory buffer and may be
+// called from the receive thread. Full buffers are written by a background
+// thread with one large write each, so disk latency never reaches the
+// socket. If the disk falls behind by more than MAX_QUEUED_BUFFERS, further
+// datagrams are dropped and counted instead of blocking the receive path.
+class CaptureRecorder : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit CaptureRecorder(QObject* parent = nullptr);
+    ~CaptureRecorder();
+
+    bool start(const QString& basePath, QString* error);
+    void stop();
+    bool isRecording() const { return recording.load(std::memory_order_acquire); }
+
+    // Thread-safe; never blocks on I/O
+    void append(const char* data, int size, qint64 receiveTimeUs);
+
+    // Configuration (takes effect on next start)
+    void setSegmentSize(qint64 bytes) { segmentSizeLimit = bytes; }
+
+    // Statistics
+    quint64 getDatagramsRecorded() const { return datagramsRecorded.load(std::memory_order_relaxed); }
+    quint64 getDatagramsDropped() const { return datagramsDropped.load(std::memory_order_relaxed); }
+    quint64 getBytesWritten() const { return bytesWritten.load(std::memory_order_relaxed); }
+    QString getBasePath() const { return basePath; }
+
+signals:
+    void errorOccurred(const QString& error);
+
+private:
+    // Producer/writer hand-off, guarded by mutex
+    QMutex mutex;
+    QWaitCondition buffersReady;
+    std::vector<char> activeBuffer;
+    std::deque<std::vector<char>> fullBuffers;
+    std::vector<std::vector<char>> freeBuffers;
+    bool stopRequested;
+
+    // Writer thread state
+    std::unique_ptr<QThread> writerThread;
+    QFile segmentFile;
+    QString basePath;
+    uint32_t segmentIndex;
+    qint64 segmentBytes;
+    qint64 segmentSizeLimit;
+    std::vector<CaptureIndexEntry_t> timeIndex;   // entries of the open segment
+
+    std::atomic<bool> recording;
+    std::atomic<quint64> datagramsRecorded;
+    std::atomic<quint64> datagramsDropped;
+    std::atomic<quint64> bytesWritten;
+
+    void writerLoop();
+    bool writeBuffer(const std::vector<char>& buffer, QString* error);
+    bool openSegment(QString* error);
+    bool closeSegment(QString* error);
+    void indexBuffer(const std::vector<char>& buffer);
+    bool queueActiveBuffer();
+    std::vector<char> takeFreeBuffer();
+
+    static constexpr size_t BUFFER_BYTES = 4 * 1024 * 1024;
+    static constexpr size_t MAX_QUEUED_BUFFERS = 16;
+    static constexpr int FLUSH_INTERVAL_MS = 500;
+    static constexpr qint64 DEFAULT_SEGMENT_BYTES = 1024LL * 1024 * 1024;
+};
+
+#endif // CAPTURERECORDER_H
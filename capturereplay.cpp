@@ -0,0 +1,189 @@
+#include "capturereplay.h"
+#include "udphandler.h"
+#include <algorithm>
+#include <limits>
+
+CaptureReplay::CaptureReplay(UdpHandler* handler, QObject* parent)
+    : QObject(parent)
+    , handler(handler)
+    , sessionStartUs(0)
+    , sessionEndUs(0)
+    , segmentIndex(0)
+    , pending{0, nullptr, 0}
+    , hasPending(false)
+    , speed(1.0)
+    , pacingOriginUs(0)
+    , currentTimeUs(0)
+    , datagramsReplayed(0)
+    , batchPerDatagram(false)
+{
+    replayTimer = new QTimer(this);
+    replayTimer->setTimerType(Qt::PreciseTimer);
+    connect(replayTimer, &QTimer::timeout, this, &CaptureReplay::replayStep);
+}
+
+CaptureReplay::~CaptureReplay()
+{
+    close();
+}
+
+bool CaptureReplay::open(const QString& path, QString* error)
+{
+    close();
+
+    segments = CaptureFile::sessionSegments(path);
+    if (segments.isEmpty()) {
+        if (error) {
+            *error = QString("No capture found at %1").arg(path);
+        }
+        return false;
+    }
+
+    // Every segment's time range comes from its index footer
+    segmentStartUs.clear();
+    for (const QString& segment : segments) {
+        if (!reader.open(segment, error)) {
+            segments.clear();
+            segmentStartUs.clear();
+            return false;
+        }
+        segmentStartUs.push_back(reader.firstTimeUs());
+        sessionEndUs = reader.lastTimeUs();
+    }
+    sessionStartUs = segmentStartUs.front();
+
+    if (!reader.open(segments.first(), error)) {
+        segments.clear();
+        return false;
+    }
+
+    segmentIndex = 0;
+    datagramsReplayed = 0;
+    hasPending = readNext();
+    currentTimeUs = hasPending ? pending.receiveTimeUs : 0;
+    return true;
+}
+
+void CaptureReplay::close()
+{
+    replayTimer->stop();
+    reader.close();
+    segments.clear();
+    segmentStartUs.clear();
+    sessionStartUs = 0;
+    sessionEndUs = 0;
+    segmentIndex = 0;
+    hasPending = false;
+}
+
+void CaptureReplay::start()
+{
+    if (!hasPending) {
+        return;
+    }
+    restartPacing();
+    replayTimer->start(speed > 0.0 ? PACED_INTERVAL_MS : 0);
+}
+
+void CaptureReplay::pause()
+{
+    replayTimer->stop();
+}
+
+bool CaptureReplay::seek(qint64 timeUs)
+{
+    if (segments.isEmpty()) {
+        return false;
+    }
+
+    // Last segment starting at or before timeUs, then its own index
+    auto segment = std::upper_bound(segmentStartUs.begin(), segmentStartUs.end(), timeUs);
+    int target = segment == segmentStartUs.begin() ? 0 : static_cast<int>(segment - segmentStartUs.begin()) - 1;
+
+    if (target != segmentIndex || !reader.isOpen()) {
+        QString error;
+        if (!reader.open(segments[target], &error)) {
+            emit errorOccurred(error);
+            hasPending = false;
+            return false;
+        }
+        segmentIndex = target;
+    }
+
+    // Records older than timeUs may fill the rest of this segment; then the next one starts after it
+    if (!reader.seekToTime(timeUs)) {
+        reader.seekToEnd();
+    }
+
+    hasPending = readNext();
+    if (hasPending) {
+        currentTimeUs = pending.receiveTimeUs;
+    }
+    restartPacing();
+    emit progress(currentTimeUs);
+    return hasPending;
+}
+
+void CaptureReplay::setSpeed(double factor)
+{
+    speed = qMax(0.0, factor);
+    if (isRunning()) {
+        restartPacing();
+        replayTimer->setInterval(speed > 0.0 ? PACED_INTERVAL_MS : 0);
+    }
+}
+
+void CaptureReplay::restartPacing()
+{
+    pacingOriginUs = hasPending ? pending.receiveTimeUs : currentTimeUs;
+    pacingClock.restart();
+}
+
+bool CaptureReplay::readNext()
+{
+    while (!reader.next(pending)) {
+        // Continue with the next segment of the session
+        if (segmentIndex + 1 >= segments.size()) {
+            return false;
+        }
+        QString error;
+        if (!reader.open(segments[++segmentIndex], &error)) {
+            emit errorOccurred(error);
+            return false;
+        }
+    }
+    return true;
+}
+
+void CaptureReplay::replayStep()
+{
+    QElapsedTimer stepTimer;
+    stepTimer.start();
+
+    // Paced replay delivers everything due by now; max speed delivers until the step budget is used
+    qint64 dueUs = speed > 0.0
+        ? pacingOriginUs + static_cast<qint64>(pacingClock.nsecsElapsed() / 1000 * speed)
+        : std::numeric_limits<qint64>::max();
+
+    while (hasPending && pending.receiveTimeUs <= dueUs) {
+        handler->ingestDatagram(pending.data, pending.size);
+        currentTimeUs = pending.receiveTimeUs;
+        if (batchPerDatagram) {
+            handler->flushIngestedDetections();
+        }
+        datagramsReplayed++;
+        hasPending = readNext();
+
+        if ((datagramsReplayed & 63) == 0 && stepTimer.nsecsElapsed() > MAX_STEP_NS) {
+            break;
+        }
+    }
+
+    handler->flushIngestedDetections();
+    emit progress(currentTimeUs);
+
+    if (!hasPending) {
+        replayTimer->stop();
+        emit finished();
+    }
+}
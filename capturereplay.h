@@ -0,0 +1,94 @@
+#ifndef CAPTUREREPLAY_H
+#define CAPTUREREPLAY_H
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <vector>
+#include "capturefile.h"
+
+class UdpHandler;
+
+// Plays a recorded capture session back into a UdpHandler, through the same
+// parse and store path as live datagrams. Segments are memory-mapped and
+// read in order, either paced by the recorded receive times (scaled by the
+// speed factor) or as fast as the handler can ingest them. seek() jumps to
+// any receive time through the segments' time indexes in O(log n).
+class CaptureReplay : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit CaptureReplay(UdpHandler* handler, QObject* parent = nullptr);
+    ~CaptureReplay();
+
+    // Opens the session that path belongs to (any segment or the base path)
+    bool open(const QString& path, QString* error);
+    void close();
+
+    void start();
+    void pause();
+    bool isRunning() const { return replayTimer->isActive(); }
+
+    // Continues from the first datagram received at or after timeUs.
+    // Returns false if the session ends before that time.
+    bool seek(qint64 timeUs);
+
+    // Receive time range of the whole session
+    qint64 getStartTimeUs() const { return sessionStartUs; }
+    qint64 getEndTimeUs() const { return sessionEndUs; }
+
+    // 1.0 = recorded pace, N = N times faster, 0 = as fast as possible
+    void setSpeed(double factor);
+    double getSpeed() const { return speed; }
+
+    // Hands the handler one batch per datagram instead of one per step, so
+    // each batch comes from a single record and getCurrentTimeUs() is its
+    // receive time while the batch is delivered
+    void setBatchPerDatagram(bool enabled) { batchPerDatagram = enabled; }
+
+    // Statistics
+    quint64 getDatagramsReplayed() const { return datagramsReplayed; }
+    qint64 getCurrentTimeUs() const { return currentTimeUs; }
+
+signals:
+    void progress(qint64 captureTimeUs);
+    void finished();
+    void errorOccurred(const QString& error);
+
+private slots:
+    void replayStep();
+
+private:
+    UdpHandler* handler;
+    QTimer* replayTimer;
+
+    QStringList segments;
+    std::vector<qint64> segmentStartUs;   // first receive time per segment
+    qint64 sessionStartUs;
+    qint64 sessionEndUs;
+    int segmentIndex;
+    CaptureReader reader;
+
+    // Next record not yet delivered
+    CaptureRecord pending;
+    bool hasPending;
+
+    // Pacing: capture time pacingOriginUs corresponds to pacingClock's start
+    double speed;
+    QElapsedTimer pacingClock;
+    qint64 pacingOriginUs;
+    qint64 currentTimeUs;
+    quint64 datagramsReplayed;
+    bool batchPerDatagram;
+
+    bool readNext();
+    void restartPacing();
+
+    // Upper bound on time spent per step so the event loop stays responsive
+    static constexpr qint64 MAX_STEP_NS = 8000000;
+    static constexpr int PACED_INTERVAL_MS = 1;
+};
+
+#endif // CAPTUREREPLAY_H
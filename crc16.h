@@ -0,0 +1,105 @@
+#ifndef CRC16_H
+#define CRC16_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// CRC-16 with the reflected polynomial 0xA001 (CRC-16/MODBUS parameters:
+// init 0xFFFF, no final XOR), as used by DSP_Settings_t and the "DETS"
+// detection frames.
+//
+// Three implementations that give bit-identical results:
+//   bitwise()  - one bit per step; the reference, usable in constant expressions
+//   bytewise() - one 256-entry table lookup per byte
+//   compute()  - slice-by-8: eight table lookups per 8-byte block
+// The tables are generated at compile time. Use compute() unless a constant
+// expression is needed.
+namespace Crc16 {
+
+constexpr uint16_t POLYNOMIAL = 0xA001;
+constexpr uint16_t INITIAL = 0xFFFF;
+
+using Table = std::array<uint16_t, 256>;
+
+constexpr uint16_t bitwise(const uint8_t* data, size_t length, uint16_t crc = INITIAL)
+{
+    for (size_t i = 0; i < length; ++i) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 1) ? static_cast<uint16_t>((crc >> 1) ^ POLYNOMIAL) : static_cast<uint16_t>(crc >> 1);
+        }
+    }
+    return crc;
+}
+
+// tables[0] is the classic byte table; tables[k][b] is the CRC contribution
+// of byte b followed by k zero bytes
+constexpr std::array<Table, 8> makeTables()
+{
+    std::array<Table, 8> tables{};
+    for (int byte = 0; byte < 256; ++byte) {
+        uint16_t crc = static_cast<uint16_t>(byte);
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 1) ? static_cast<uint16_t>((crc >> 1) ^ POLYNOMIAL) : static_cast<uint16_t>(crc >> 1);
+        }
+        tables[0][byte] = crc;
+    }
+    for (int slice = 1; slice < 8; ++slice) {
+        for (int byte = 0; byte < 256; ++byte) {
+            uint16_t previous = tables[slice - 1][byte];
+            tables[slice][byte] = static_cast<uint16_t>((previous >> 8) ^ tables[0][previous & 0xFF]);
+        }
+    }
+    return tables;
+}
+
+inline constexpr std::array<Table, 8> TABLES = makeTables();
+
+constexpr uint16_t bytewise(const uint8_t* data, size_t length, uint16_t crc = INITIAL)
+{
+    for (size_t i = 0; i < length; ++i) {
+        crc = static_cast<uint16_t>((crc >> 8) ^ TABLES[0][(crc ^ data[i]) & 0xFF]);
+    }
+    return crc;
+}
+
+inline uint16_t compute(const void* buffer, size_t length, uint16_t crc = INITIAL)
+{
+    const uint8_t* data = static_cast<const uint8_t*>(buffer);
+
+    while (length >= 8) {
+        // Byte-wise loads keep this independent of alignment and endianness
+        uint8_t block[8];
+        std::memcpy(block, data, sizeof(block));
+        crc = static_cast<uint16_t>(TABLES[7][block[0] ^ (crc & 0xFF)] ^
+                                    TABLES[6][block[1] ^ (crc >> 8)] ^
+                                    TABLES[5][block[2]] ^
+                                    TABLES[4][block[3]] ^
+                                    TABLES[3][block[4]] ^
+                                    TABLES[2][block[5]] ^
+                                    TABLES[1][block[6]] ^
+                                    TABLES[0][block[7]]);
+        data += 8;
+        length -= 8;
+    }
+    return bytewise(data, length, crc);
+}
+
+namespace Detail {
+constexpr uint8_t CHECK_INPUT[] = { '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+constexpr uint8_t ZERO_INPUT[] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+}
+
+// Test vectors: the catalogued CRC-16/MODBUS check value, and agreement of
+// the table with the bit-at-a-time reference
+static_assert(bitwise(Detail::CHECK_INPUT, sizeof(Detail::CHECK_INPUT)) == 0x4B37, "CRC-16/MODBUS check value");
+static_assert(bytewise(Detail::CHECK_INPUT, sizeof(Detail::CHECK_INPUT)) == 0x4B37, "CRC-16 table mismatch");
+static_assert(bitwise(Detail::ZERO_INPUT, sizeof(Detail::ZERO_INPUT)) ==
+              bytewise(Detail::ZERO_INPUT, sizeof(Detail::ZERO_INPUT)), "CRC-16 table mismatch");
+static_assert(bitwise(Detail::CHECK_INPUT, 0) == INITIAL, "CRC-16 of empty input");
+
+} // namespace Crc16
+
+#endif // CRC16_H
@@ -1,11 +1,34 @@
 #include "customchart.h"
+#include "decimation.h"
+#include "latencystats.h"
+#include "detectionrasterizer.h"
 #include <QPaintEvent>
 #include <QResizeEvent>
 #include <QWheelEvent>
+#include <QHelpEvent>
+#include <QToolTip>
 #include <QPolygon>
 #include <QFont>
+#include <QElapsedTimer>
+#include <QDateTime>
 #include <cmath>
 
+namespace {
+
+DetectionData toDetectionData(const TargetDetection& target)
+{
+    DetectionData detection;
+    detection.target_id = target.target_id;
+    detection.radius = target.radius;
+    detection.radial_speed = target.radial_speed;
+    detection.azimuth = target.azimuth;
+    detection.amplitude = target.amplitude;
+    detection.timestamp = target.timestamp;
+    return detection;
+}
+
+} // namespace
+
 CustomChart::CustomChart(ChartType type, QWidget* parent)
     : QWidget(parent)
     , chartType(type)
@@ -15,6 +38,16 @@ CustomChart::CustomChart(ChartType type, QWidget* parent)
     , showGrid(true)
     , maxDataPoints(1024)
     , zoomLevel(1.0)
+    , showTrails(true)
+    , trackTimeoutMs(DEFAULT_TRACK_TIMEOUT_MS)
+    , staticLayersValid(false)
+    , rasterDirty(true)
+    , displayMode(TrackDisplay)
+    , lastPaintTimeMs(0.0)
+    , averagePaintTimeMs(0.0)
+    , paintCount(0)
+    , latencyStats(nullptr)
+    , animating(false)
     , gen(rd())
     , dis(-1.0, 1.0)
     , fft_dis(0.0, 100.0)
@@ -28,32 +61,117 @@ CustomChart::CustomChart(ChartType type, QWidget* parent)
     connect(updateTimer, &QTimer::timeout, this, &CustomChart::updateData);
     updateTimer->start(1000); // Update every second
     
+    persistenceTimer = new QTimer(this);
+    persistenceTimer->setSingleShot(true);
+    connect(persistenceTimer, &QTimer::timeout, this, &CustomChart::scheduleRepaint);
+    
     calculatePlotArea();
 }
 
 CustomChart::~CustomChart() = default;
 
+void CustomChart::setThreadedRendering(bool enabled)
+{
+    if (chartType != DETECTION_CHART || enabled == isThreadedRendering()) {
+        return;
+    }
+    
+    if (enabled) {
+        rasterizer = std::make_unique<DetectionRasterizer>();
+        connect(rasterizer.get(), &DetectionRasterizer::frameReady, this, &CustomChart::scheduleRepaint);
+    } else {
+        // Joins the worker; undelivered frameReady events die with the object
+        rasterizer.reset();
+    }
+    hitGrid.clear();
+    requestRepaint();
+}
+
+void CustomChart::setLatencyStats(LatencyStats* stats)
+{
+    QMutexLocker locker(&dataMutex);
+    latencyStats = stats;
+    pendingReceiveTimes.clear();
+}
+
+void CustomChart::setDetectionDisplayMode(DetectionDisplayMode mode)
+{
+    if (chartType != DETECTION_CHART || mode == displayMode) {
+        return;
+    }
+    displayMode = mode;
+    hitGrid.clear();
+    requestRepaint();
+}
+
+void CustomChart::setPersistence(int persistenceMs)
+{
+    QMutexLocker locker(&dataMutex);
+    persistenceMap.setPersistence(persistenceMs);
+    requestRepaint();
+}
+
+int CustomChart::getPersistence() const
+{
+    QMutexLocker locker(&dataMutex);
+    return persistenceMap.getPersistence();
+}
+
 void CustomChart::setFrozen(bool freeze)
 {
     frozen = freeze;
-    if (frozen) {
+    if (frozen || renderScheduler) {
         updateTimer->stop();
     } else {
         updateTimer->start(1000);
     }
 }
 
+void CustomChart::setRenderScheduler(RenderScheduler* scheduler)
+{
+    if (renderScheduler) {
+        renderScheduler->removeWidget(this);
+    }
+    renderScheduler = scheduler;
+    
+    // The scheduler paces every repaint; the periodic timer is only the fallback
+    if (renderScheduler) {
+        renderScheduler->addWidget(this);
+        updateTimer->stop();
+    } else if (!frozen) {
+        updateTimer->start();
+    }
+}
+
+void CustomChart::requestRepaint()
+{
+    rasterDirty = true;
+    scheduleRepaint();
+}
+
+void CustomChart::scheduleRepaint()
+{
+    if (renderScheduler) {
+        renderScheduler->markDirty(this);
+    } else {
+        update();
+    }
+}
+
 void CustomChart::setThreshold(double newThreshold)
 {
     threshold = newThreshold;
-    update();
+    requestRepaint();
 }
 
 void CustomChart::setUpdateInterval(int intervalMs)
 {
     if (updateTimer) {
         updateTimer->stop();
-        updateTimer->start(intervalMs);
+        updateTimer->setInterval(intervalMs);
+        if (!frozen && !renderScheduler) {
+            updateTimer->start();
+        }
     }
 }
 
@@ -68,7 +186,8 @@ void CustomChart::zoomIn()
     if (zoomLevel > 10.0) {
         zoomLevel = 10.0;
     }
-    update();
+    invalidateStaticLayers();
+    requestRepaint();
     emit zoomChanged(zoomLevel);
 }
 
@@ -78,79 +197,138 @@ void CustomChart::zoomOut()
     if (zoomLevel < 0.5) {
         zoomLevel = 0.5;
     }
-    update();
+    invalidateStaticLayers();
+    requestRepaint();
     emit zoomChanged(zoomLevel);
 }
 
 void CustomChart::resetZoom()
 {
     zoomLevel = 1.0;
-    update();
+    invalidateStaticLayers();
+    requestRepaint();
     emit zoomChanged(zoomLevel);
 }
 
 void CustomChart::addDetection(const TargetDetection& detection)
 {
+    // Only the detection chart draws tracks and their afterglow
+    if (chartType != DETECTION_CHART) return;
+    
     QMutexLocker locker(&dataMutex);
-    detections.push_back(detection);
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    tracks.update(toDetectionData(detection), now);
+    persistenceMap.add(detection.radius, detection.azimuth, now);
+    expireTracks(now);
+    
+    requestRepaint();
+}
+
+void CustomChart::addDetections(const QVector<DetectionData>& batch)
+{
+    if (batch.isEmpty() || chartType != DETECTION_CHART) return;
     
-    // Keep only recent detections
-    if (detections.size() > maxDataPoints) {
-        detections.erase(detections.begin());
+    QMutexLocker locker(&dataMutex);
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    for (const auto& detection : batch) {
+        tracks.update(detection, now);
+        persistenceMap.add(detection.radius, detection.azimuth, now);
+        
+        if (latencyStats && detection.receive_time_us > 0) {
+            if (!pendingReceiveTimes.empty() && pendingReceiveTimes.back().first == detection.receive_time_us) {
+                pendingReceiveTimes.back().second++;
+            } else if (pendingReceiveTimes.size() < MAX_PENDING_RECEIVE_TIMES) {
+                pendingReceiveTimes.emplace_back(detection.receive_time_us, 1);
+            }
+        }
     }
     
-    update();
+    expireTracks(now);
+    
+    requestRepaint();
 }
 
 void CustomChart::setDetections(const std::vector<TargetDetection>& newDetections)
 {
-    QMutexLocker locker(&dataMutex);
-    detections = newDetections;
+    if (chartType != DETECTION_CHART) return;
     
-    // Limit size
-    if (detections.size() > maxDataPoints) {
-        detections.erase(detections.begin(), detections.begin() + (detections.size() - maxDataPoints));
+    QMutexLocker locker(&dataMutex);
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    tracks.clear();
+    for (const auto& detection : newDetections) {
+        tracks.update(toDetectionData(detection), now);
+        persistenceMap.add(detection.radius, detection.azimuth, now);
     }
+    tracks.trimTo(maxDataPoints);
     
-    update();
+    requestRepaint();
 }
 
 void CustomChart::clearDetections()
 {
     QMutexLocker locker(&dataMutex);
-    detections.clear();
-    update();
+    tracks.clear();
+    persistenceMap.clear();
+    hitGrid.clear();
+    requestRepaint();
+}
+
+void CustomChart::setSmoothing(bool enabled)
+{
+    QMutexLocker locker(&dataMutex);
+    tracks.setFilteringEnabled(enabled);
+    requestRepaint();
+}
+
+bool CustomChart::isSmoothing() const
+{
+    QMutexLocker locker(&dataMutex);
+    return tracks.isFilteringEnabled();
+}
+
+void CustomChart::expireTracks(qint64 nowMs)
+{
+    // Measured from the newest update, so a paused stream keeps its picture
+    tracks.expire(nowMs - trackTimeoutMs);
+    tracks.trimTo(maxDataPoints);
 }
 
 void CustomChart::setFFTData(const std::vector<double>& data)
 {
     QMutexLocker locker(&dataMutex);
     fftData = data;
-    update();
+    requestRepaint();
 }
 
 void CustomChart::setRawSignalData(const std::vector<double>& data)
 {
     QMutexLocker locker(&dataMutex);
     rawSignalData = data;
-    update();
+    requestRepaint();
 }
 
 void CustomChart::setHistogramData(const std::vector<double>& data)
 {
     QMutexLocker locker(&dataMutex);
     histogramData = data;
-    update();
+    requestRepaint();
 }
 
 void CustomChart::paintEvent(QPaintEvent* event)
 {
     Q_UNUSED(event);
+    QElapsedTimer paintTimer;
+    paintTimer.start();
+    
+    updateStaticLayers();
+    
     QPainter painter(this);
-    painter.setRenderHint(QPainter::Antialiasing);
     
-    drawBackground(painter);
+    // Static background, grid and polar scale come from the cache
+    painter.drawPixmap(0, 0, backgroundCache);
+    painter.setRenderHint(QPainter::Antialiasing);
     
+    // Only the data layer is drawn every frame
     switch (chartType) {
     case FFT_CHART:
         drawFFTChart(painter);
@@ -159,34 +337,152 @@ void CustomChart::paintEvent(QPaintEvent* event)
         drawRawSignalChart(painter);
         break;
     case DETECTION_CHART:
-        drawDetectionChart(painter);
+        drawDetectionMarkers(painter);
         break;
     case HISTOGRAM_CHART:
         drawHistogramChart(painter);
         break;
     }
     
-    if (showLegend) {
-        drawLegend(painter);
+    // Title, zoom indicator and legend sit on top of the data
+    painter.drawPixmap(0, 0, overlayCache);
+    painter.end();
+    
+    recordPaintTime(paintTimer.nsecsElapsed());
+    
+    // Everything added since the previous paint is on screen now.
+    // pendingReceiveTimes is guarded by dataMutex like the rest of the batch state.
+    {
+        QMutexLocker locker(&dataMutex);
+        if (latencyStats && !pendingReceiveTimes.empty()) {
+            qint64 now = LatencyStats::nowUs();
+            for (const auto& run : pendingReceiveTimes) {
+                latencyStats->record(LatencyStats::PaintStage, run.first, now, run.second);
+            }
+            pendingReceiveTimes.clear();
+        }
+    }
+    
+    // Extrapolated tracks keep moving between detections
+    if (animating && renderScheduler && !frozen) {
+        renderScheduler->markDirty(this);
     }
 }
 
+void CustomChart::changeEvent(QEvent* event)
+{
+    if (event->type() == QEvent::PaletteChange || event->type() == QEvent::StyleChange) {
+        invalidateStaticLayers();
+    }
+    QWidget::changeEvent(event);
+}
+
+void CustomChart::invalidateStaticLayers()
+{
+    staticLayersValid = false;
+    
+    // Size or zoom may have moved every marker; hits resume with the next paint
+    hitGrid.clear();
+    rasterDirty = true;
+}
+
+void CustomChart::updateStaticLayers()
+{
+    StaticLayerKey key;
+    key.size = size();
+    key.zoomLevel = zoomLevel;
+    key.devicePixelRatio = devicePixelRatioF();
+    key.paletteKey = palette().cacheKey();
+    key.showGrid = showGrid;
+    key.showLegend = showLegend;
+    
+    if (staticLayersValid && key == staticLayerKey) {
+        return;
+    }
+    staticLayerKey = key;
+    
+    QSize pixelSize = size() * key.devicePixelRatio;
+    
+    // Background layer: everything below the data
+    backgroundCache = QPixmap(pixelSize);
+    backgroundCache.setDevicePixelRatio(key.devicePixelRatio);
+    backgroundCache.fill(Qt::transparent);
+    {
+        QPainter cachePainter(&backgroundCache);
+        cachePainter.setRenderHint(QPainter::Antialiasing);
+        drawBackground(cachePainter);
+        if (chartType == DETECTION_CHART) {
+            drawDetectionGrid(cachePainter);
+        }
+    }
+    
+    // Overlay layer: everything drawn on top of the data
+    overlayCache = QPixmap(pixelSize);
+    overlayCache.setDevicePixelRatio(key.devicePixelRatio);
+    overlayCache.fill(Qt::transparent);
+    {
+        QPainter cachePainter(&overlayCache);
+        cachePainter.setRenderHint(QPainter::Antialiasing);
+        if (chartType == DETECTION_CHART) {
+            drawDetectionOverlay(cachePainter);
+        }
+        if (showLegend) {
+            drawLegend(cachePainter);
+        }
+    }
+    
+    staticLayersValid = true;
+}
+
+void CustomChart::recordPaintTime(qint64 elapsedNs)
+{
+    double elapsedMs = elapsedNs / 1e6;
+    lastPaintTimeMs = elapsedMs;
+    // Exponential moving average over roughly the last 20 frames
+    averagePaintTimeMs = paintCount == 0 ? elapsedMs : averagePaintTimeMs * 0.95 + elapsedMs * 0.05;
+    paintCount++;
+}
+
+void CustomChart::resetPaintStatistics()
+{
+    lastPaintTimeMs = 0.0;
+    averagePaintTimeMs = 0.0;
+    paintCount = 0;
+}
+
 void CustomChart::mousePressEvent(QMouseEvent* event)
 {
     if (chartType == DETECTION_CHART) {
-        TargetDetection detection = getDetectionAt(event->pos());
-        if (detection.target_id != 0) {
-            emit detectionClicked(detection);
+        // Track ID 0 is valid, so a miss is an empty result, not a zero ID
+        if (std::optional<TargetDetection> detection = getDetectionAt(event->pos())) {
+            emit detectionClicked(*detection);
         }
     }
     
     QWidget::mousePressEvent(event);
 }
 
+bool CustomChart::event(QEvent* event)
+{
+    if (event->type() == QEvent::ToolTip && chartType == DETECTION_CHART) {
+        QHelpEvent* helpEvent = static_cast<QHelpEvent*>(event);
+        if (std::optional<TargetDetection> detection = getDetectionAt(helpEvent->pos())) {
+            QToolTip::showText(helpEvent->globalPos(), detectionToolTip(*detection), this);
+        } else {
+            QToolTip::hideText();
+            event->ignore();
+        }
+        return true;
+    }
+    
+    return QWidget::event(event);
+}
+
 void CustomChart::resizeEvent(QResizeEvent* event)
 {
     QWidget::resizeEvent(event);
     calculatePlotArea();
+    invalidateStaticLayers();
 }
 
 void CustomChart::wheelEvent(QWheelEvent* event)
@@ -207,7 +503,7 @@ void CustomChart::updateData()
 {
     if (!frozen) {
         //generateSampleData();
-        update();
+        requestRepaint();
         emit dataUpdated();
     }
 }
@@ -356,25 +652,19 @@ void CustomChart::drawFFTChart(QPainter& painter)
     
     // Draw threshold line
     painter.setPen(QPen(QColor(255, 140, 0), 2));  // Dark orange
+    int bottom = plotArea.bottom();
+    double yScale = plotArea.height() / 100.0;
+    auto amplitudeToY = [bottom, yScale](double value) { return static_cast<int>(bottom - value * yScale); };
+    
     if (!thresholdData.empty()) {
-        QPolygon thresholdPoly;
-        for (size_t i = 0; i < thresholdData.size(); ++i) {
-            int x = plotArea.left() + i * plotArea.width() / (thresholdData.size() - 1);
-            int y = plotArea.bottom() - (thresholdData[i] / 100.0) * plotArea.height();
-            thresholdPoly << QPoint(x, y);
-        }
-        painter.drawPolyline(thresholdPoly);
+        Decimation::buildPolyline(polylineBuffer, thresholdData, plotArea.left(), plotArea.width(), amplitudeToY);
+        painter.drawPolyline(polylineBuffer);
     }
     
     // Draw FFT data
     painter.setPen(QPen(QColor(34, 139, 34), 2));  // Forest green
-    QPolygon fftPoly;
-    for (size_t i = 0; i < fftData.size(); ++i) {
-        int x = plotArea.left() + i * plotArea.width() / (fftData.size() - 1);
-        int y = plotArea.bottom() - (fftData[i] / 100.0) * plotArea.height();
-        fftPoly << QPoint(x, y);
-    }
-    painter.drawPolyline(fftPoly);
+    Decimation::buildPolyline(polylineBuffer, fftData, plotArea.left(), plotArea.width(), amplitudeToY);
+    painter.drawPolyline(polylineBuffer);
 }
 
 void CustomChart::drawRawSignalChart(QPainter& painter)
@@ -393,13 +683,10 @@ void CustomChart::drawRawSignalChart(QPainter& painter)
     
     // Draw raw signal data
     painter.setPen(QPen(QColor(0, 191, 255), 2));  // Deep sky blue
-    QPolygon signalPoly;
-    for (size_t i = 0; i < rawSignalData.size(); ++i) {
-        int x = plotArea.left() + i * plotArea.width() / (rawSignalData.size() - 1);
-        int y = zeroY - rawSignalData[i] * plotArea.height() / 4;
-        signalPoly << QPoint(x, y);
-    }
-    painter.drawPolyline(signalPoly);
+    double yScale = plotArea.height() / 4.0;
+    auto signalToY = [zeroY, yScale](double value) { return static_cast<int>(zeroY - value * yScale); };
+    Decimation::buildPolyline(polylineBuffer, rawSignalData, plotArea.left(), plotArea.width(), signalToY);
+    painter.drawPolyline(polylineBuffer);
     
     // Draw labels
     painter.setPen(QColor(25, 25, 112));  // Midnight blue
@@ -408,15 +695,11 @@ void CustomChart::drawRawSignalChart(QPainter& painter)
     painter.drawText(plotArea.center().x() - 20, height() - 10, "Samples");
 }
 
-void CustomChart::drawDetectionChart(QPainter& painter)
+void CustomChart::detectionGeometry(QPoint& center, int& maxRadius) const
 {
-    QMutexLocker locker(&dataMutex);
-    
-    drawGrid(painter);
-    
     // Calculate semicircle parameters - DOUBLED THE SIZE
-    QPoint center = QPoint(plotArea.center().x(), plotArea.bottom() - 20);
-    int maxRadius = (qMin(plotArea.width(), plotArea.height()) * zoomLevel) - 40; // Doubled from /2 to *1, adjusted margin
+    center = QPoint(plotArea.center().x(), plotArea.bottom() - 20);
+    maxRadius = (qMin(plotArea.width(), plotArea.height()) * zoomLevel) - 40; // Doubled from /2 to *1, adjusted margin
     
     // Ensure semicircle fits within the plot area
     if (maxRadius > plotArea.height() - 40) {
@@ -425,6 +708,15 @@ void CustomChart::drawDetectionChart(QPainter& painter)
     if (maxRadius > plotArea.width() / 2 - 40) {
         maxRadius = plotArea.width() / 2 - 40;
     }
+}
+
+void CustomChart::drawDetectionGrid(QPainter& painter)
+{
+    drawGrid(painter);
+    
+    QPoint center;
+    int maxRadius;
+    detectionGeometry(center, maxRadius);
     
     // Draw range circles (semicircles from -90 to +90 degrees)
     painter.setPen(QPen(QColor(148, 163, 184, 180), 2, Qt::SolidLine));  // Enhanced gray with transparency
@@ -504,76 +796,52 @@ void CustomChart::drawDetectionChart(QPainter& painter)
         painter.setPen(QColor(30, 41, 59));
         painter.drawText(x - textRect.width()/2, y + textRect.height()/2 - 2, angleLabel);
     }
+}
+
+void CustomChart::drawDetectionMarkers(QPainter& painter)
+{
+    QMutexLocker locker(&dataMutex);
+    
+    DetectionRenderer::Geometry geometry;
+    detectionGeometry(geometry.center, geometry.maxRadius);
+    geometry.area = size();
+    
+    // The afterglow sits below the tracks and fades between detections
+    if (displayMode != TrackDisplay) {
+        persistenceMap.draw(painter, geometry.center, geometry.maxRadius, QDateTime::currentMSecsSinceEpoch());
+        if (!persistenceMap.isEmpty() && !frozen && !persistenceTimer->isActive()) {
+            persistenceTimer->start(persistenceMap.refreshInterval());
+        }
+        if (displayMode == PersistenceDisplay) {
+            hitGrid.clear();
+            animating = false;
+            return;
+        }
+    }
     
-    // Draw detections (only show detections within -90 to +90 degree range)
-    if (!detections.empty()) {
-        for (const auto& detection : detections) {
-            // Only show detections within the semicircle range
-            if (detection.azimuth >= -90 && detection.azimuth <= 90) {
-                // Calculate position
-                double normalizedRadius = qMin(detection.radius / 100.0, 1.0); // Normalize to 0-100m
-                double rad = detection.azimuth * M_PI / 180.0;
-                
-                int x = center.x() + normalizedRadius * maxRadius * cos(rad);
-                int y = center.y() - normalizedRadius * maxRadius * sin(rad);
-                
-                // Color based on radial speed
-                QColor color = getColorForSpeed(detection.radial_speed);
-                
-                // Size based on amplitude, with minimum size for visibility
-                int size = qMax(12, qMin(24, (int)(detection.amplitude / 5.0 + 12))); // Increased base size
-                
-                // Draw shadow first
-                QColor shadowColor(0, 0, 0, 80);
-                painter.setPen(QPen(shadowColor, 1));
-                painter.setBrush(QBrush(shadowColor));
-                painter.drawEllipse(x - size/2 + 2, y - size/2 + 2, size, size);
-                
-                // Draw outer glow
-                QRadialGradient glowGradient(QPointF(x, y), size);
-                glowGradient.setColorAt(0, QColor(color.red(), color.green(), color.blue(), 180));
-                glowGradient.setColorAt(0.7, QColor(color.red(), color.green(), color.blue(), 100));
-                glowGradient.setColorAt(1, QColor(color.red(), color.green(), color.blue(), 0));
-                painter.setPen(Qt::NoPen);
-                painter.setBrush(QBrush(glowGradient));
-                painter.drawEllipse(x - size, y - size, size * 2, size * 2);
-                
-                // Draw main detection marker with gradient
-                QRadialGradient markerGradient(QPointF(x - size/4, y - size/4), size/2);
-                markerGradient.setColorAt(0, color.lighter(150));
-                markerGradient.setColorAt(1, color.darker(120));
-                
-                painter.setPen(QPen(color.darker(140), 2));
-                painter.setBrush(QBrush(markerGradient));
-                painter.drawEllipse(x - size/2, y - size/2, size, size);
-                
-                // Draw inner highlight
-                QColor highlightColor = color.lighter(200);
-                highlightColor.setAlpha(120);
-                painter.setPen(Qt::NoPen);
-                painter.setBrush(QBrush(highlightColor));
-                painter.drawEllipse(x - size/4, y - size/4, size/2, size/2);
-                
-                // Draw target ID with enhanced styling
-                painter.setPen(QColor(30, 41, 59));  // Dark blue text
-                painter.setFont(QFont("Arial", 9, QFont::Bold));
-                QString idText = QString::number(detection.target_id);
-                QFontMetrics fm(painter.font());
-                QRect textRect = fm.boundingRect(idText);
-                
-                // Draw text background
-                QRect bgRect(x + size/2 + 4, y - size/2 - 4, textRect.width() + 4, textRect.height() + 2);
-                painter.setPen(Qt::NoPen);
-                painter.setBrush(QBrush(QColor(255, 255, 255, 200)));
-                painter.drawRoundedRect(bgRect, 3, 3);
-                
-                // Draw text
-                painter.setPen(QColor(30, 41, 59));
-                painter.drawText(x + size/2 + 6, y - size/2 + textRect.height() - 6, idText);
-            }
+    if (rasterizer) {
+        // Hand the worker a snapshot when the tracks changed or are still moving,
+        // then show whatever it finished last
+        if (rasterDirty || (rasterizer->isAnimating() && renderScheduler && !frozen)) {
+            std::unique_ptr<DetectionRasterizer::Frame> frame = rasterizer->acquireFrame();
+            frame->tracks = tracks;
+            frame->geometry = geometry;
+            frame->devicePixelRatio = painter.device()->devicePixelRatioF();
+            frame->showTrails = showTrails;
+            frame->receiveTimes.swap(pendingReceiveTimes);
+            rasterizer->submit(std::move(frame));
+            rasterDirty = false;
         }
+        rasterizer->composite(painter, pendingReceiveTimes);
+        animating = false;
+        return;
     }
     
+    animating = detectionRenderer.render(painter, tracks, geometry, LatencyStats::nowUs(), showTrails, hitGrid);
+}
+
+void CustomChart::drawDetectionOverlay(QPainter& painter)
+{
     // Draw enhanced title and labels
     QFont titleFont("Arial", 14, QFont::Bold);
     QFont subtitleFont("Arial", 11, QFont::Normal);
@@ -661,63 +929,40 @@ void CustomChart::drawHistogramChart(QPainter& painter)
     painter.drawText(plotArea.center().x() - 20, height() - 10, "Velocity/Range");
 }
 
-TargetDetection CustomChart::getDetectionAt(const QPoint& point) const
+std::optional<TargetDetection> CustomChart::getDetectionAt(const QPoint& point) const
 {
     QMutexLocker locker(&dataMutex);
     
     if (chartType != DETECTION_CHART) {
-        return TargetDetection();
+        return std::nullopt;
     }
     
-    QPoint center = plotArea.center();
-    int maxRadius = qMin(plotArea.width(), plotArea.height()) / 2 - 20;
-    
-    for (const auto& detection : detections) {
-        QPoint detectionPoint = detectionToPoint(detection);
-        
-        // Check if click is within detection circle
-        int distance = sqrt(pow(point.x() - detectionPoint.x(), 2) + pow(point.y() - detectionPoint.y(), 2));
-        int detectionSize = qMax(8, qMin(20, (int)(detection.amplitude / 5.0 + 8)));
-
-        if (distance <= detectionSize / 2) {
-            return detection;
-        }
+    // Hit-test against the markers as they were last painted
+    if (displayMode == PersistenceDisplay) {
+        return std::nullopt;
     }
-    
-    return TargetDetection();
+    if (rasterizer) {
+        return rasterizer->hitAt(point);
+    }
+    if (const TargetDetection* detection = hitGrid.hitAt(point)) {
+        return *detection;
+    }
+    return std::nullopt;
 }
 
-QPoint CustomChart::detectionToPoint(const TargetDetection& detection) const
+QString CustomChart::detectionToolTip(const TargetDetection& detection)
 {
-    QPoint center = QPoint(plotArea.center().x(), plotArea.bottom() - 20);
-    int maxRadius = (qMin(plotArea.width(), plotArea.height()) * zoomLevel) - 40; // Doubled from /2 to *1, adjusted margin
-    
-    // Ensure semicircle fits within the plot area
-    if (maxRadius > plotArea.height() - 40) {
-        maxRadius = plotArea.height() - 40;
-    }
-    if (maxRadius > plotArea.width() / 2 - 40) {
-        maxRadius = plotArea.width() / 2 - 40;
-    }
-    
-    double normalizedRadius = qMin(detection.radius / 100.0, 1.0);
-    double rad = detection.azimuth * M_PI / 180.0;
-    
-    int x = center.x() + normalizedRadius * maxRadius * cos(rad);
-    int y = center.y() - normalizedRadius * maxRadius * sin(rad);
-    
-    return QPoint(x, y);
+    return QString("Target %1\nRange: %2 m\nAzimuth: %3°\nSpeed: %4 m/s\nAmplitude: %5 dB")
+        .arg(detection.target_id)
+        .arg(detection.radius, 0, 'f', 2)
+        .arg(detection.azimuth, 0, 'f', 1)
+        .arg(detection.radial_speed, 0, 'f', 2)
+        .arg(detection.amplitude, 0, 'f', 1);
 }
 
 QColor CustomChart::getColorForSpeed(double speed) const
 {
-    if (speed > 2.0) {
-        return QColor(255, 0, 0); // Red for approaching
-    } else if (speed < -2.0) {
-        return QColor(0, 255, 0); // Green for receding
-    } else {
-        return QColor(255, 255, 0); // Yellow for stationary
-    }
+    return MarkerAtlas::colorFor(MarkerAtlas::speedClassFor(speed));
 }
 
 QColor CustomChart::getColorForAmplitude(double amplitude) const
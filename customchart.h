@@ -7,10 +7,24 @@
 #include <QMouseEvent>
 #include <QPainter>
 #include <QPalette>
+#include <QPixmap>
+#include <QPointer>
+#include <QPolygon>
+#include <QVector>
 #include <vector>
 #include <memory>
+#include <optional>
 #include <random>
+#include <utility>
 #include "structures.h"
+#include "hitgrid.h"
+#include "detectionrenderer.h"
+#include "persistencemap.h"
+#include "renderscheduler.h"
+#include "trackstore.h"
+
+class LatencyStats;
+class DetectionRasterizer;
 
 class CustomChart : public QWidget
 {
@@ -23,6 +37,14 @@ public:
         DETECTION_CHART,
         HISTOGRAM_CHART
     };
+    
+    // What the detection chart shows: live tracks, the afterglow of recent
+    // traffic, or tracks on top of the afterglow
+    enum DetectionDisplayMode {
+        TrackDisplay,
+        PersistenceDisplay,
+        TrackAndPersistenceDisplay
+    };
 
     explicit CustomChart(ChartType type, QWidget* parent = nullptr);
     ~CustomChart();
@@ -31,6 +53,23 @@ public:
     void setFrozen(bool freeze);
     bool isFrozen() const { return frozen; }
     
+    // Routes every repaint through scheduler, which paces it to the frame
+    // rate; nullptr (or a destroyed scheduler) repaints directly
+    void setRenderScheduler(RenderScheduler* scheduler);
+    
+    // Detection chart only: draw markers and trails on a worker thread and
+    // only composite the finished image on the GUI thread
+    void setThreadedRendering(bool enabled);
+    bool isThreadedRendering() const { return rasterizer != nullptr; }
+    const DetectionRasterizer* getRasterizer() const { return rasterizer.get(); }
+    
+    // Detection chart only; detections accumulate in the afterglow whatever
+    // the mode, so switching to it shows the recent history at once
+    void setDetectionDisplayMode(DetectionDisplayMode mode);
+    DetectionDisplayMode getDetectionDisplayMode() const { return displayMode; }
+    void setPersistence(int persistenceMs);
+    int getPersistence() const;
+    
     // Configuration
     void setThreshold(double threshold);
     double getThreshold() const { return threshold; }
@@ -40,6 +79,7 @@ public:
     
     // Data management
     void addDetection(const TargetDetection& detection);
+    void addDetections(const QVector<DetectionData>& batch);
     void setDetections(const std::vector<TargetDetection>& detections);
     void clearDetections();
     
@@ -49,15 +89,32 @@ public:
     void setHistogramData(const std::vector<double>& data);
     
     // Display options
-    void setShowLegend(bool show) { showLegend = show; update(); }
-    void setShowGrid(bool show) { showGrid = show; update(); }
-    void setMaxDataPoints(int maxPoints) { maxDataPoints = maxPoints; }
+    void setShowLegend(bool show) { showLegend = show; invalidateStaticLayers(); requestRepaint(); }
+    void setShowGrid(bool show) { showGrid = show; invalidateStaticLayers(); requestRepaint(); }
+    void setMaxDataPoints(int maxPoints) { maxDataPoints = maxPoints; }   // live tracks on the detection chart
+    void setShowTrails(bool show) { showTrails = show; requestRepaint(); }
+    void setTrackTimeout(int timeoutMs) { trackTimeoutMs = timeoutMs; }
+    
+    // Draws tracks at their Kalman-filtered position, extrapolated to the
+    // paint time, with a short predicted path ahead
+    void setSmoothing(bool enabled);
+    bool isSmoothing() const;
     
     // Zoom functionality
     void zoomIn();
     void zoomOut();
     void resetZoom();
     double getZoomLevel() const { return zoomLevel; }
+    
+    // Paint timing
+    double getLastPaintTimeMs() const { return lastPaintTimeMs; }
+    double getAveragePaintTimeMs() const { return averagePaintTimeMs; }
+    quint64 getPaintCount() const { return paintCount; }
+    void resetPaintStatistics();
+    
+    // Records the paint stage for detections added through addDetections();
+    // stats must outlive the chart or be reset to nullptr first
+    void setLatencyStats(LatencyStats* stats);
 
 signals:
     void dataUpdated();
@@ -65,10 +122,12 @@ signals:
     void zoomChanged(double zoomLevel);
 
 protected:
+    bool event(QEvent* event) override;
     void paintEvent(QPaintEvent* event) override;
     void mousePressEvent(QMouseEvent* event) override;
     void resizeEvent(QResizeEvent* event) override;
     void wheelEvent(QWheelEvent* event) override;
+    void changeEvent(QEvent* event) override;
 
 private slots:
     void updateData();
@@ -82,6 +141,63 @@ private:
     bool showGrid;
     int maxDataPoints;
     double zoomLevel;
+    bool showTrails;
+    int trackTimeoutMs;
+    
+    // Static layer caches. Everything that only depends on the widget size,
+    // zoom and theme is rendered once and blitted on every paint.
+    struct StaticLayerKey {
+        QSize size;
+        double zoomLevel = 0.0;
+        qreal devicePixelRatio = 0.0;
+        qint64 paletteKey = 0;
+        bool showGrid = false;
+        bool showLegend = false;
+        
+        bool operator==(const StaticLayerKey& other) const {
+            return size == other.size && zoomLevel == other.zoomLevel &&
+                   devicePixelRatio == other.devicePixelRatio && paletteKey == other.paletteKey &&
+                   showGrid == other.showGrid && showLegend == other.showLegend;
+        }
+    };
+    QPixmap backgroundCache;   // background, grid, rings, spokes and scale labels
+    QPixmap overlayCache;      // title, zoom indicator and legend
+    StaticLayerKey staticLayerKey;
+    bool staticLayersValid;
+    
+    // Detection layer drawn on the GUI thread, and the markers as drawn by
+    // the last paint, for clicks and tooltips (GUI thread only)
+    DetectionRenderer detectionRenderer;
+    HitGrid hitGrid;
+    
+    // Set when threaded rendering is on; rasterDirty means the worker has
+    // not seen the current tracks yet
+    std::unique_ptr<DetectionRasterizer> rasterizer;
+    bool rasterDirty;
+    
+    // Afterglow of recent detections; persistenceTimer keeps it fading
+    // while nothing else repaints
+    DetectionDisplayMode displayMode;
+    PersistenceMap persistenceMap;
+    QTimer* persistenceTimer;
+    
+    // Paint statistics
+    double lastPaintTimeMs;
+    double averagePaintTimeMs;
+    quint64 paintCount;
+    
+    // Receive times of detections not yet painted, one entry per run of
+    // detections from the same datagram
+    LatencyStats* latencyStats;
+    std::vector<std::pair<qint64, quint32>> pendingReceiveTimes;
+    static constexpr size_t MAX_PENDING_RECEIVE_TIMES = 4096;
+    
+    // Frame pacing; animating while smoothed tracks are being extrapolated
+    QPointer<RenderScheduler> renderScheduler;
+    bool animating;
+    
+    // Tracks not updated for this long before the newest one disappear
+    static constexpr int DEFAULT_TRACK_TIMEOUT_MS = 5000;
     
     // Timers
     QTimer* updateTimer;
@@ -92,7 +208,8 @@ private:
     std::vector<double> rawSignalData;
     std::vector<double> histogramData;
     std::vector<double> thresholdData;
-    std::vector<TargetDetection> detections;
+    TrackStore tracks;         // latest detection and recent positions per target_id
+    QPolygon polylineBuffer;   // reused by the FFT and raw signal polylines
     
     // Chart dimensions
     QRect plotArea;
@@ -107,7 +224,9 @@ private:
     // Drawing methods
     void drawFFTChart(QPainter& painter);
     void drawRawSignalChart(QPainter& painter);
-    void drawDetectionChart(QPainter& painter);
+    void drawDetectionGrid(QPainter& painter);
+    void drawDetectionMarkers(QPainter& painter);
+    void drawDetectionOverlay(QPainter& painter);
     void drawHistogramChart(QPainter& painter);
     
     // Helper methods
@@ -116,13 +235,22 @@ private:
     void drawAxes(QPainter& painter);
     void drawLegend(QPainter& painter);
     void calculatePlotArea();
+    void detectionGeometry(QPoint& center, int& maxRadius) const;
+    void expireTracks(qint64 nowMs);
+    
+    // Static layer cache
+    void invalidateStaticLayers();
+    void updateStaticLayers();
+    void requestRepaint();     // data or layout changed
+    void scheduleRepaint();    // only the composite is stale
+    void recordPaintTime(qint64 elapsedNs);
     
     // Data generation (for testing)
     void generateSampleData();
     
     // Detection interaction
-    TargetDetection getDetectionAt(const QPoint& point) const;
-    QPoint detectionToPoint(const TargetDetection& detection) const;
+    std::optional<TargetDetection> getDetectionAt(const QPoint& point) const;   // empty if no marker is hit
+    static QString detectionToolTip(const TargetDetection& detection);
     
     // Color utilities
     QColor getColorForSpeed(double speed) const;
@@ -0,0 +1,82 @@
+#ifndef DECIMATION_H
+#define DECIMATION_H
+
+#include <QPolygon>
+#include <cstddef>
+#include <vector>
+
+// Min/max decimation of sampled series for drawing.
+//
+// When a series has more samples than the plot has pixel columns, every
+// column is reduced to the smallest and largest sample that falls into it.
+// The resulting polyline has at most two points per column, so the drawing
+// cost depends on the widget width rather than the FFT size, and every peak
+// and notch is still drawn at its exact value.
+namespace Decimation {
+
+// Smallest and largest value in [first, last), which must not be empty.
+// Written as plain compare-selects so the compiler can turn the loop into
+// packed min/max instructions.
+inline void columnMinMax(const double* first, const double* last, double& lo, double& hi)
+{
+    double minValue = *first;
+    double maxValue = *first;
+    for (const double* value = first + 1; value < last; ++value) {
+        double v = *value;
+        minValue = v < minValue ? v : minValue;
+        maxValue = v > maxValue ? v : maxValue;
+    }
+    lo = minValue;
+    hi = maxValue;
+}
+
+// Replaces out with the polyline for samples spread across width pixels
+// starting at left. toY maps a sample value to a widget y coordinate.
+template <typename ToY>
+void buildPolyline(QPolygon& out, const std::vector<double>& samples, int left, int width, ToY toY)
+{
+    out.resize(0);
+    size_t count = samples.size();
+    if (count == 0 || width <= 0) {
+        return;
+    }
+
+    // Few samples: one point per sample
+    if (count <= static_cast<size_t>(width) * 2) {
+        out.reserve(static_cast<int>(count));
+        size_t last = count > 1 ? count - 1 : 1;
+        for (size_t i = 0; i < count; ++i) {
+            out << QPoint(left + static_cast<int>(i * width / last), toY(samples[i]));
+        }
+        return;
+    }
+
+    // Many samples: a min/max pair per pixel column
+    out.reserve(width * 2);
+    const double* data = samples.data();
+    int previousY = toY(samples[0]);
+    for (int column = 0; column < width; ++column) {
+        size_t begin = column * count / width;
+        size_t end = (column + 1) * count / width;
+
+        double lo, hi;
+        columnMinMax(data + begin, data + end, lo, hi);
+        int minY = toY(lo);
+        int maxY = toY(hi);
+
+        // Start with the extreme closer to where the line left off, so the
+        // connecting segment between columns stays short
+        int x = left + column;
+        if (qAbs(previousY - minY) <= qAbs(previousY - maxY)) {
+            out << QPoint(x, minY) << QPoint(x, maxY);
+            previousY = maxY;
+        } else {
+            out << QPoint(x, maxY) << QPoint(x, minY);
+            previousY = minY;
+        }
+    }
+}
+
+} // namespace Decimation
+
+#endif // DECIMATION_H
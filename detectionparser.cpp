@@ -0,0 +1,287 @@
+#include "detectionparser.h"
+#include <QDateTime>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStringList>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+enum Field {
+    NoField,
+    TargetIdField,
+    RangeField,
+    SpeedField,
+    AzimuthField,
+    AmplitudeField,
+    TimestampField
+};
+
+inline bool isSeparator(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+// Keys are told apart by length first, so each token costs at most two memcmp
+inline Field matchKey(const char* token, size_t length)
+{
+    switch (length) {
+    case 6:
+        if (std::memcmp(token, "TgtId:", 6) == 0) return TargetIdField;
+        if (std::memcmp(token, "Range:", 6) == 0) return RangeField;
+        if (std::memcmp(token, "Speed:", 6) == 0) return SpeedField;
+        break;
+    case 8:
+        if (std::memcmp(token, "azimuth:", 8) == 0) return AzimuthField;
+        break;
+    case 10:
+        if (std::memcmp(token, "amplitude:", 10) == 0) return AmplitudeField;
+        if (std::memcmp(token, "timestamp:", 10) == 0) return TimestampField;
+        break;
+    default:
+        break;
+    }
+    return NoField;
+}
+
+// Unparsable values leave the field at its default, like QString::toFloat() did
+template <typename T>
+inline void parseNumber(const char* first, const char* last, T& value)
+{
+    T parsed{};
+    if (std::from_chars(first, last, parsed).ec == std::errc()) {
+        value = parsed;
+    }
+}
+
+inline void storeField(Field field, const char* first, const char* last, DetectionData& detection)
+{
+    switch (field) {
+    case TargetIdField:  parseNumber(first, last, detection.target_id); break;
+    case RangeField:     parseNumber(first, last, detection.radius); break;
+    case SpeedField:     parseNumber(first, last, detection.radial_speed); break;
+    case AzimuthField:   parseNumber(first, last, detection.azimuth); break;
+    case AmplitudeField: parseNumber(first, last, detection.amplitude); break;
+    case TimestampField: parseNumber(first, last, detection.timestamp); break;
+    case NoField:        break;
+    }
+}
+
+} // namespace
+
+int DetectionParser::parse(const char* data, size_t size, std::vector<DetectionData>& out)
+{
+    if (isBinaryFrame(data, size)) {
+        return parseBinary(data, size, out);
+    }
+    return parseText(data, size, out);
+}
+
+bool DetectionParser::isBinaryFrame(const char* data, size_t size)
+{
+    return size >= sizeof(DETECTION_FRAME_MAGIC) &&
+           std::memcmp(data, DETECTION_FRAME_MAGIC, sizeof(DETECTION_FRAME_MAGIC)) == 0;
+}
+
+int DetectionParser::parseBinary(const char* data, size_t size, std::vector<DetectionData>& out,
+                                 uint32_t* sequence)
+{
+    if (size < sizeof(DetectionFrameHeader_t)) {
+        return -1;
+    }
+
+    DetectionFrameHeader_t header;
+    std::memcpy(&header, data, sizeof(header));
+
+    if (header.version != DETECTION_FRAME_VERSION || header.header_size < sizeof(DetectionFrameHeader_t)) {
+        return -1;
+    }
+
+    // Bounds check once for the whole record array
+    size_t payloadSize = static_cast<size_t>(header.count) * sizeof(DetectionRecord_t);
+    if (header.header_size > size || payloadSize > size - header.header_size) {
+        return -1;
+    }
+
+    // Senders that do not compute a checksum leave it at 0
+    const char* record = data + header.header_size;
+    if (header.checksum != 0 && Crc16::compute(record, payloadSize) != header.checksum) {
+        return -1;
+    }
+
+    if (sequence) {
+        *sequence = header.sequence;
+    }
+
+    size_t first = out.size();
+    out.resize(first + header.count);
+    for (uint16_t i = 0; i < header.count; ++i, record += sizeof(DetectionRecord_t)) {
+        // memcpy keeps the unaligned packed reads well-defined
+        DetectionRecord_t packed;
+        std::memcpy(&packed, record, sizeof(packed));
+
+        DetectionData& detection = out[first + i];
+        detection.target_id = packed.target_id;
+        detection.radius = packed.radius;
+        detection.radial_speed = packed.radial_speed;
+        detection.azimuth = packed.azimuth;
+        detection.amplitude = packed.amplitude;
+        detection.timestamp = packed.timestamp;
+    }
+
+    return header.count;
+}
+
+int DetectionParser::parseText(const char* data, size_t size, std::vector<DetectionData>& out)
+{
+    const char* cursor = data;
+    const char* end = data + size;
+    int parsed = 0;
+
+    while (cursor < end) {
+        const char* lineEnd = static_cast<const char*>(std::memchr(cursor, '\n', end - cursor));
+        if (!lineEnd) {
+            lineEnd = end;
+        }
+
+        DetectionData detection;
+        bool hasKey = false;
+        Field pendingField = NoField;
+
+        while (cursor < lineEnd) {
+            while (cursor < lineEnd && isSeparator(*cursor)) {
+                ++cursor;
+            }
+            if (cursor == lineEnd) {
+                break;
+            }
+
+            const char* tokenStart = cursor;
+            while (cursor < lineEnd && !isSeparator(*cursor)) {
+                ++cursor;
+            }
+
+            // A key's value is the token that follows it
+            if (pendingField != NoField) {
+                storeField(pendingField, tokenStart, cursor, detection);
+                pendingField = NoField;
+                continue;
+            }
+
+            pendingField = matchKey(tokenStart, cursor - tokenStart);
+            hasKey |= pendingField != NoField;
+        }
+
+        if (hasKey) {
+            out.push_back(detection);
+            parsed++;
+        }
+
+        cursor = lineEnd + 1;
+    }
+
+    return parsed;
+}
+
+// Moved from UdpHandler::parseJsonData(); only a complete single object is
+// stamped with the local time, array entries keep the default amplitude and timestamp
+int DetectionParser::parseJson(const char* data, size_t size, std::vector<DetectionData>& out)
+{
+    QJsonParseError error;
+    QJsonDocument document = QJsonDocument::fromJson(QByteArray::fromRawData(data, static_cast<int>(size)), &error);
+    if (error.error != QJsonParseError::NoError || !document.isObject()) {
+        return -1;
+    }
+
+    QJsonObject obj = document.object();
+    int parsed = 0;
+
+    // Handle single detection
+    if (obj.contains("target_id") && obj.contains("radius") &&
+        obj.contains("radial_speed") && obj.contains("azimuth") &&
+        obj.contains("amplitude") && obj.contains("timestamp")) {
+
+        DetectionData detection;
+        detection.target_id = obj["target_id"].toInt();
+        detection.radius = obj["radius"].toDouble();
+        detection.radial_speed = obj["radial_speed"].toDouble();
+        detection.azimuth = obj["azimuth"].toDouble();
+        QJsonValue amplitudeValue = obj.value("amplitude");
+        detection.amplitude = amplitudeValue.isUndefined() ? 0.0 : amplitudeValue.toDouble();
+        detection.timestamp = QDateTime::currentMSecsSinceEpoch();
+
+        if (isPlausible(detection)) {
+            out.push_back(detection);
+            parsed++;
+        }
+    }
+    // Handle array of detections
+    else if (obj.contains("detections") && obj["detections"].isArray()) {
+        QJsonArray detArray = obj["detections"].toArray();
+        for (const auto& detValue : detArray) {
+            if (detValue.isObject()) {
+                QJsonObject detObj = detValue.toObject();
+                DetectionData detection;
+                detection.target_id = detObj["target_id"].toInt();
+                detection.radius = detObj["radius"].toDouble();
+                detection.radial_speed = detObj["radial_speed"].toDouble();
+                detection.azimuth = detObj["azimuth"].toDouble();
+
+                if (isPlausible(detection)) {
+                    out.push_back(detection);
+                    parsed++;
+                }
+            }
+        }
+    }
+
+    return parsed;
+}
+
+// Moved from UdpHandler::parseCsvData(); fields past the azimuth are ignored
+int DetectionParser::parseCsv(const char* data, size_t size, std::vector<DetectionData>& out)
+{
+    QStringList lines = QString::fromUtf8(data, static_cast<int>(size)).trimmed().split('\n');
+    int parsed = 0;
+
+    for (const QString& line : lines) {
+        QString trimmedLine = line.trimmed();
+        if (trimmedLine.isEmpty()) continue;
+
+        QStringList parts = trimmedLine.split(',');
+        if (parts.size() >= 4) {
+            DetectionData detection;
+            bool ok = true;
+
+            detection.target_id = parts[0].toInt(&ok);
+            if (!ok) continue;
+
+            detection.radius = parts[1].toDouble(&ok);
+            if (!ok) continue;
+
+            detection.radial_speed = parts[2].toDouble(&ok);
+            if (!ok) continue;
+
+            detection.azimuth = parts[3].toDouble(&ok);
+            if (!ok) continue;
+
+            if (isPlausible(detection)) {
+                out.push_back(detection);
+                parsed++;
+            }
+        }
+    }
+
+    return parsed;
+}
+
+bool DetectionParser::isPlausible(const DetectionData& detection)
+{
+    return detection.target_id <= 999 &&
+           detection.radius >= 0 && detection.radius <= 1000 &&           // 1km max range
+           detection.azimuth >= -180 && detection.azimuth <= 180 &&
+           std::fabs(detection.radial_speed) <= 200;                      // 200 m/s max speed
+}
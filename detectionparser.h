@@ -0,0 +1,61 @@
+#ifndef DETECTIONPARSER_H
+#define DETECTIONPARSER_H
+
+#include <vector>
+#include <cstddef>
+#include "structures.h"
+
+// Parsers for the radar's detection datagrams.
+//
+// Text protocol: "TgtId: <id> Range: <m> Speed: <m/s> azimuth: <deg> amplitude: <dB> timestamp: <ms>"
+// Works directly on the datagram bytes, recognises the six keys without
+// building strings and converts the numbers with std::from_chars, so the
+// only allocation is the (amortised, caller-owned) growth of out.
+//
+// Binary protocol: "DETS" frames (see DetectionFrameHeader_t in structures.h).
+//
+// JSON and CSV: alternative encodings used by test tools and older sensor
+// firmware. They are not recognised by parse(); callers choose them explicitly.
+class DetectionParser
+{
+public:
+    // Parses either protocol, chosen per datagram by its leading magic.
+    // Returns the number of detections appended, or -1 for a malformed frame.
+    static int parse(const char* data, size_t size, std::vector<DetectionData>& out);
+
+    // Appends one detection for every line that contains at least one known
+    // key; every line starts from a default-constructed DetectionData.
+    // Returns the number of detections appended.
+    static int parseText(const char* data, size_t size, std::vector<DetectionData>& out);
+
+    // True when the datagram starts with the "DETS" magic
+    static bool isBinaryFrame(const char* data, size_t size);
+
+    // Decodes a "DETS" frame after checking version, bounds and, when the
+    // header carries one, the payload CRC. Returns the number of detections
+    // appended, or -1 if the frame is truncated, corrupt or of an
+    // unsupported version. sequence receives the frame sequence number.
+    static int parseBinary(const char* data, size_t size, std::vector<DetectionData>& out,
+                           uint32_t* sequence = nullptr);
+
+    // The JSON and CSV decoders formerly in UdpHandler, kept with their
+    // original behaviour but not wired into ingest.
+    //
+    // Decodes a single object carrying all of target_id, radius,
+    // radial_speed, azimuth, amplitude and timestamp, stamped with the local
+    // time, or {"detections":[{..},..]} whose entries only supply the ID,
+    // range, speed and azimuth. Detections outside the plausible envelope
+    // are skipped. Returns the number appended, or -1 if the datagram is not
+    // a JSON object.
+    static int parseJson(const char* data, size_t size, std::vector<DetectionData>& out);
+
+    // Decodes "id,range,speed,azimuth" lines; further fields are ignored.
+    // Lines with a non-integer ID, fewer than four numeric fields or
+    // implausible values are skipped. Returns the number appended.
+    static int parseCsv(const char* data, size_t size, std::vector<DetectionData>& out);
+
+    // Range, azimuth, speed and ID limits the JSON and CSV decoders enforce
+    static bool isPlausible(const DetectionData& detection);
+};
+
+#endif // DETECTIONPARSER_H
@@ -0,0 +1,139 @@
+#include "detectionrasterizer.h"
+#include "latencystats.h"
+#include <QElapsedTimer>
+#include <QMutexLocker>
+
+// DetectionRasterizer Implementation
+DetectionRasterizer::DetectionRasterizer(QObject* parent)
+    : QObject(parent)
+    , stopRequested(false)
+    , renderer(MarkerAtlas::ImageBacking)
+{
+    worker.reset(QThread::create([this]() { workerLoop(); }));
+    worker->setObjectName("DetectionRasterizer");
+    worker->start();
+}
+
+DetectionRasterizer::~DetectionRasterizer()
+{
+    {
+        QMutexLocker locker(&mutex);
+        stopRequested = true;
+        wake.wakeOne();
+    }
+    worker->wait();
+}
+
+std::unique_ptr<DetectionRasterizer::Frame> DetectionRasterizer::acquireFrame()
+{
+    QMutexLocker locker(&mutex);
+    if (spare) {
+        return std::move(spare);
+    }
+    return std::make_unique<Frame>();
+}
+
+void DetectionRasterizer::submit(std::unique_ptr<Frame> frame)
+{
+    QMutexLocker locker(&mutex);
+    if (pending) {
+        // The replaced frame was never shown; its detections first appear in this one
+        frame->receiveTimes.insert(frame->receiveTimes.end(),
+                                   pending->receiveTimes.begin(), pending->receiveTimes.end());
+        stats.superseded++;
+    }
+    pending = std::move(frame);
+    wake.wakeOne();
+}
+
+bool DetectionRasterizer::composite(QPainter& painter, ReceiveTimes& presentedReceiveTimes)
+{
+    QMutexLocker locker(&mutex);
+    if (front.image.isNull()) {
+        return false;
+    }
+    painter.drawImage(QPointF(0, 0), front.image);
+
+    presentedReceiveTimes.insert(presentedReceiveTimes.end(),
+                                 front.receiveTimes.begin(), front.receiveTimes.end());
+    front.receiveTimes.clear();
+    return true;
+}
+
+std::optional<TargetDetection> DetectionRasterizer::hitAt(const QPointF& point) const
+{
+    QMutexLocker locker(&mutex);
+    if (const TargetDetection* detection = front.hits.hitAt(point)) {
+        return *detection;
+    }
+    return std::nullopt;
+}
+
+bool DetectionRasterizer::isAnimating() const
+{
+    QMutexLocker locker(&mutex);
+    return front.animating;
+}
+
+DetectionRasterizer::Statistics DetectionRasterizer::statistics() const
+{
+    QMutexLocker locker(&mutex);
+    return stats;
+}
+
+void DetectionRasterizer::workerLoop()
+{
+    QMutexLocker locker(&mutex);
+    while (true) {
+        while (!pending && !stopRequested) {
+            wake.wait(&mutex);
+        }
+        if (stopRequested) {
+            break;
+        }
+
+        std::unique_ptr<Frame> frame = std::move(pending);
+        locker.unlock();
+
+        QElapsedTimer renderTimer;
+        renderTimer.start();
+        renderFrame(*frame);
+        double elapsedMs = renderTimer.nsecsElapsed() / 1e6;
+
+        locker.relock();
+        std::swap(front, back);
+        front.receiveTimes = std::move(frame->receiveTimes);
+
+        // Detections of an image that was never composited first appear in this one
+        front.receiveTimes.insert(front.receiveTimes.end(), back.receiveTimes.begin(), back.receiveTimes.end());
+        back.receiveTimes.clear();
+
+        frame->receiveTimes.clear();
+        spare = std::move(frame);
+
+        stats.lastRenderMs = elapsedMs;
+        // Exponential moving average over roughly the last 20 frames
+        stats.averageRenderMs = stats.rendered == 0 ? elapsedMs : stats.averageRenderMs * 0.95 + elapsedMs * 0.05;
+        stats.rendered++;
+
+        locker.unlock();
+        emit frameReady();
+        locker.relock();
+    }
+}
+
+void DetectionRasterizer::renderFrame(const Frame& frame)
+{
+    // The back image is only ever touched here, so reusing it never detaches
+    QSize pixelSize = frame.geometry.area * frame.devicePixelRatio;
+    if (back.image.size() != pixelSize) {
+        back.image = QImage(pixelSize, QImage::Format_ARGB32_Premultiplied);
+    }
+    back.image.setDevicePixelRatio(frame.devicePixelRatio);
+    back.image.fill(Qt::transparent);
+
+    QPainter painter(&back.image);
+    painter.setRenderHint(QPainter::Antialiasing);
+    back.animating = renderer.render(painter, frame.tracks, frame.geometry, LatencyStats::nowUs(),
+                                     frame.showTrails, back.hits);
+}
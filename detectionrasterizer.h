@@ -0,0 +1,97 @@
+#ifndef DETECTIONRASTERIZER_H
+#define DETECTIONRASTERIZER_H
+
+#include <QObject>
+#include <QImage>
+#include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+#include "detectionrenderer.h"
+
+// Rasterises the detection chart's dynamic layer on a worker thread.
+//
+// The chart copies its tracks into a Frame and submits it; the worker draws
+// the frame into the back QImage with an ImageBacking DetectionRenderer,
+// swaps it with the front image and emits frameReady(). paintEvent then
+// only composites the front image, so antialiased drawing of thousands of
+// markers never blocks input handling on the GUI thread.
+//
+// At most one frame waits: a frame submitted while the worker is busy
+// replaces the one still waiting. Finished frames are recycled through
+// acquireFrame(), so steady-state snapshots only copy, never allocate.
+class DetectionRasterizer : public QObject
+{
+    Q_OBJECT
+
+public:
+    using ReceiveTimes = std::vector<std::pair<qint64, quint32>>;
+
+    // Immutable once submitted; the worker owns it from then on
+    struct Frame {
+        TrackStore tracks;
+        DetectionRenderer::Geometry geometry;
+        qreal devicePixelRatio = 1.0;
+        bool showTrails = true;
+        ReceiveTimes receiveTimes;   // detections first shown by this frame
+    };
+
+    struct Statistics {
+        quint64 rendered = 0;
+        quint64 superseded = 0;      // replaced before the worker got to them
+        double lastRenderMs = 0.0;
+        double averageRenderMs = 0.0;
+    };
+
+    explicit DetectionRasterizer(QObject* parent = nullptr);
+    ~DetectionRasterizer();
+
+    std::unique_ptr<Frame> acquireFrame();
+    void submit(std::unique_ptr<Frame> frame);
+
+    // Draws the newest finished image and appends the receive times of
+    // detections it shows for the first time; false before the first image
+    bool composite(QPainter& painter, ReceiveTimes& presentedReceiveTimes);
+
+    // Hit-tests the markers of the newest finished image; empty on a miss
+    std::optional<TargetDetection> hitAt(const QPointF& point) const;
+
+    // True while the newest image shows extrapolated tracks
+    bool isAnimating() const;
+
+    Statistics statistics() const;
+
+signals:
+    // Emitted from the worker thread when a new image is ready
+    void frameReady();
+
+private:
+    struct Buffer {
+        QImage image;
+        HitGrid hits;
+        bool animating = false;
+        ReceiveTimes receiveTimes;
+    };
+
+    mutable QMutex mutex;   // guards everything below except back and renderer
+    QWaitCondition wake;
+    std::unique_ptr<Frame> pending;
+    std::unique_ptr<Frame> spare;
+    Buffer front;
+    bool stopRequested;
+    Statistics stats;
+
+    // Worker thread only
+    Buffer back;
+    DetectionRenderer renderer;
+
+    std::unique_ptr<QThread> worker;
+
+    void workerLoop();
+    void renderFrame(const Frame& frame);
+};
+
+#endif // DETECTIONRASTERIZER_H
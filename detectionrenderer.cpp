@@ -0,0 +1,132 @@
+#include "detectionrenderer.h"
+#include <cmath>
+
+// DetectionRenderer Implementation
+DetectionRenderer::DetectionRenderer(MarkerAtlas::Backing backing)
+    : markerAtlas(backing)
+{
+}
+
+bool DetectionRenderer::render(QPainter& painter, const TrackStore& tracks, const Geometry& geometry, qint64 nowUs,
+                               bool showTrails, HitGrid& hits)
+{
+    if (showTrails) {
+        drawTrails(painter, tracks, geometry);
+    }
+    if (tracks.isFilteringEnabled()) {
+        drawPredictions(painter, tracks, geometry, nowUs);
+    }
+
+    // Draw each track at its latest or smoothed position (only within -90 to +90 degree range)
+    // and record where it went for hit-testing
+    markerAtlas.prepare(painter.device()->devicePixelRatioF());
+    hits.reset(geometry.area);
+    bool animating = false;
+    for (const auto& track : tracks) {
+        const DetectionData& detection = track.latest;
+        if (tracks.isFilteringEnabled() && track.filter.isInitialized() &&
+            nowUs < track.filter.lastUpdateUs() + MAX_EXTRAPOLATION_US) {
+            animating = true;
+        }
+        double radius, azimuth;
+        // Only show tracks within the semicircle range
+        if (trackPosition(tracks, track, nowUs, radius, azimuth)) {
+            QPointF position = polarToPoint(radius, azimuth, geometry.center, geometry.maxRadius);
+
+            // Color based on radial speed, size based on amplitude
+            int size = MarkerAtlas::markerSizeFor(detection.amplitude);
+            markerAtlas.addMarker(position, MarkerAtlas::speedClassFor(detection.radial_speed), size);
+            markerAtlas.addLabel(position, size, detection.target_id);
+
+            TargetDetection drawn = detection.toTargetDetection();
+            drawn.radius = static_cast<float>(radius);
+            drawn.azimuth = static_cast<float>(azimuth);
+            hits.add(position, size / 2.0, drawn);
+        }
+    }
+    markerAtlas.flush(painter);
+    hits.build();
+
+    return animating;
+}
+
+QPointF DetectionRenderer::polarToPoint(double radius, double azimuth, const QPoint& center, int maxRadius)
+{
+    double normalizedRadius = qMin(radius / 100.0, 1.0); // Normalize to 0-100m
+    double rad = azimuth * M_PI / 180.0;
+    return QPointF(center.x() + normalizedRadius * maxRadius * cos(rad),
+                   center.y() - normalizedRadius * maxRadius * sin(rad));
+}
+
+bool DetectionRenderer::trackPosition(const TrackStore& tracks, const TrackStore::Track& track, qint64 nowUs,
+                                      double& radius, double& azimuth)
+{
+    if (tracks.isFilteringEnabled() && track.filter.isInitialized()) {
+        // Extrapolate to the paint time, but not indefinitely for a track that went quiet
+        qint64 timeUs = qMin(nowUs, track.filter.lastUpdateUs() + MAX_EXTRAPOLATION_US);
+        track.filter.predictPolar(timeUs, radius, azimuth);
+    } else {
+        radius = track.latest.radius;
+        azimuth = track.latest.azimuth;
+    }
+    return azimuth >= -90 && azimuth <= 90;
+}
+
+void DetectionRenderer::drawTrails(QPainter& painter, const TrackStore& tracks, const Geometry& geometry)
+{
+    // One drawLines call per speed color over the recent positions of every track
+    for (auto& segments : trailSegments) {
+        segments.clear();
+    }
+    for (const auto& track : tracks) {
+        auto& segments = trailSegments[MarkerAtlas::speedClassFor(track.latest.radial_speed)];
+        QPointF previous;
+        bool havePrevious = false;
+        for (int i = 0; i < track.historySize(); ++i) {
+            const TrackStore::TrackPoint& point = track.historyAt(i);
+            if (point.azimuth < -90 || point.azimuth > 90) {
+                havePrevious = false;
+                continue;
+            }
+            QPointF current = polarToPoint(point.radius, point.azimuth, geometry.center, geometry.maxRadius);
+            if (havePrevious) {
+                segments.append(QLineF(previous, current));
+            }
+            previous = current;
+            havePrevious = true;
+        }
+    }
+    for (int speedClass = 0; speedClass < MarkerAtlas::SpeedClassCount; ++speedClass) {
+        if (trailSegments[speedClass].isEmpty()) continue;
+        QColor color = MarkerAtlas::colorFor(static_cast<MarkerAtlas::SpeedClass>(speedClass));
+        color.setAlpha(110);
+        painter.setPen(QPen(color, 1.5));
+        painter.drawLines(trailSegments[speedClass]);
+    }
+}
+
+void DetectionRenderer::drawPredictions(QPainter& painter, const TrackStore& tracks, const Geometry& geometry,
+                                        qint64 nowUs)
+{
+    // A dashed segment shows where each smoothed track is heading
+    for (auto& segments : predictionSegments) {
+        segments.clear();
+    }
+    for (const auto& track : tracks) {
+        if (!track.filter.isInitialized()) continue;
+        qint64 fromUs = qMin(nowUs, track.filter.lastUpdateUs() + MAX_EXTRAPOLATION_US);
+        double fromRadius, fromAzimuth, toRadius, toAzimuth;
+        track.filter.predictPolar(fromUs, fromRadius, fromAzimuth);
+        track.filter.predictPolar(fromUs + PREDICTION_HORIZON_US, toRadius, toAzimuth);
+        if (fromAzimuth < -90 || fromAzimuth > 90 || toAzimuth < -90 || toAzimuth > 90) continue;
+        predictionSegments[MarkerAtlas::speedClassFor(track.latest.radial_speed)].append(
+            QLineF(polarToPoint(fromRadius, fromAzimuth, geometry.center, geometry.maxRadius),
+                   polarToPoint(toRadius, toAzimuth, geometry.center, geometry.maxRadius)));
+    }
+    for (int speedClass = 0; speedClass < MarkerAtlas::SpeedClassCount; ++speedClass) {
+        if (predictionSegments[speedClass].isEmpty()) continue;
+        QPen pen(MarkerAtlas::colorFor(static_cast<MarkerAtlas::SpeedClass>(speedClass)), 1.5, Qt::DashLine);
+        painter.setPen(pen);
+        painter.drawLines(predictionSegments[speedClass]);
+    }
+}
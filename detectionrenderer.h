@@ -0,0 +1,55 @@
+#ifndef DETECTIONRENDERER_H
+#define DETECTIONRENDERER_H
+
+#include <QPainter>
+#include <QLineF>
+#include <QPoint>
+#include <QSize>
+#include <QVector>
+#include <array>
+#include "markeratlas.h"
+#include "hitgrid.h"
+#include "trackstore.h"
+
+// Draws the dynamic layer of the detection chart: trails, predicted paths,
+// markers and ID labels for every track, and records each marker in a
+// HitGrid. Used directly by CustomChart's paintEvent, and by the
+// DetectionRasterizer worker with an ImageBacking atlas. One instance must
+// only ever be used from one thread.
+class DetectionRenderer
+{
+public:
+    // Smoothed tracks are extrapolated at most this far past their last
+    // update; the dashed prediction reaches this far ahead
+    static constexpr qint64 MAX_EXTRAPOLATION_US = 1000000;
+    static constexpr qint64 PREDICTION_HORIZON_US = 500000;
+
+    struct Geometry {
+        QPoint center;
+        int maxRadius;
+        QSize area;   // widget size, for the hit grid
+    };
+
+    explicit DetectionRenderer(MarkerAtlas::Backing backing = MarkerAtlas::PixmapBacking);
+
+    // Returns true while any smoothed track is still being extrapolated, so
+    // the picture changes with time alone
+    bool render(QPainter& painter, const TrackStore& tracks, const Geometry& geometry, qint64 nowUs,
+                bool showTrails, HitGrid& hits);
+
+    static QPointF polarToPoint(double radius, double azimuth, const QPoint& center, int maxRadius);
+
+    // Where a track is drawn at nowUs; false outside the -90 to +90 degree plot
+    static bool trackPosition(const TrackStore& tracks, const TrackStore::Track& track, qint64 nowUs,
+                              double& radius, double& azimuth);
+
+private:
+    MarkerAtlas markerAtlas;
+    std::array<QVector<QLineF>, MarkerAtlas::SpeedClassCount> trailSegments;   // reused, one batch per color
+    std::array<QVector<QLineF>, MarkerAtlas::SpeedClassCount> predictionSegments;
+
+    void drawTrails(QPainter& painter, const TrackStore& tracks, const Geometry& geometry);
+    void drawPredictions(QPainter& painter, const TrackStore& tracks, const Geometry& geometry, qint64 nowUs);
+};
+
+#endif // DETECTIONRENDERER_H
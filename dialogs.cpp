@@ -1,4 +1,6 @@
 #include "dialogs.h"
+#include "latencystats.h"
+#include <QHeaderView>
 #include <QSlider>
 #include <QSettings>
 
@@ -16,8 +18,8 @@ UdpConfigDialog::UdpConfigDialog(QWidget* parent)
     // Connect UDP handler signals
     connect(udpHandler.get(), &UdpHandler::connectionStatusChanged, 
             this, &UdpConfigDialog::onConnectionStatusChanged);
-    connect(udpHandler.get(), &UdpHandler::newDetectionReceived, 
-            this, &UdpConfigDialog::onNewDetectionReceived);
+    connect(udpHandler.get(), &UdpHandler::detectionsBatchReceived, 
+            this, &UdpConfigDialog::onDetectionsBatchReceived);
     connect(udpHandler.get(), &UdpHandler::errorOccurred, 
             this, &UdpConfigDialog::onErrorOccurred);
     connect(udpHandler.get(), &UdpHandler::statisticsUpdated, 
@@ -127,10 +129,10 @@ void UdpConfigDialog::onConnectionStatusChanged(bool connected)
     emit connectionStatusChanged(connected);
 }
 
-void UdpConfigDialog::onNewDetectionReceived(const DetectionData& detection)
+void UdpConfigDialog::onDetectionsBatchReceived(const QVector<DetectionData>& detections)
 {
-    //qDebug()<<"onNewDetectionReceived";
-    emit dataReceived(detection);
+    //qDebug()<<"onDetectionsBatchReceived";
+    emit detectionsReceived(detections);
 }
 
 void UdpConfigDialog::onErrorOccurred(const QString& error)
@@ -140,10 +142,14 @@ void UdpConfigDialog::onErrorOccurred(const QString& error)
 
 void UdpConfigDialog::onStatisticsUpdated(int received, int dropped, double rate)
 {
-    statisticsLabel->setText(QString("Packets: %1 received, %2 dropped, %3 pps")
-                            .arg(received)
-                            .arg(dropped)
-                            .arg(rate, 0, 'f', 1));
+    QString text = QString("Packets: %1 received, %2 dropped, %3 pps")
+                   .arg(received)
+                   .arg(dropped)
+                   .arg(rate, 0, 'f', 1);
+    if (int detectionsDropped = udpHandler->getDetectionsDropped()) {
+        text += QString(", %1 detections dropped").arg(detectionsDropped);
+    }
+    statisticsLabel->setText(text);
 }
 
 // Output Configuration Dialog Implementation
@@ -1226,3 +1232,85 @@ void DSPSettingsDialog::updateUIFromSettings()
 {
     updateAmplificationControls();
 }
+
+// LatencyDiagnosticsDialog Implementation
+LatencyDiagnosticsDialog::LatencyDiagnosticsDialog(LatencyStats* stats, QWidget* parent)
+    : QDialog(parent)
+    , stats(stats)
+{
+    setWindowTitle("Latency Diagnostics");
+    setMinimumSize(560, 240);
+    
+    setupUI();
+    
+    // Non-modal; refreshes while open
+    refreshTimer = new QTimer(this);
+    connect(refreshTimer, &QTimer::timeout, this, &LatencyDiagnosticsDialog::refresh);
+    refreshTimer->start(500);
+    refresh();
+}
+
+void LatencyDiagnosticsDialog::setupUI()
+{
+    QVBoxLayout* layout = new QVBoxLayout(this);
+    
+    QLabel* description = new QLabel("Age of detections at each stage, measured from datagram receipt.");
+    description->setWordWrap(true);
+    layout->addWidget(description);
+    
+    stageTable = new QTableWidget(LatencyStats::STAGE_COUNT, 6);
+    stageTable->setHorizontalHeaderLabels({"Samples", "p50 (ms)", "p90 (ms)", "p99 (ms)", "Max (ms)", "Mean (ms)"});
+    QStringList stageNames;
+    for (int stage = 0; stage < LatencyStats::STAGE_COUNT; ++stage) {
+        stageNames << LatencyStats::stageName(static_cast<LatencyStats::Stage>(stage));
+    }
+    stageTable->setVerticalHeaderLabels(stageNames);
+    stageTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    stageTable->setSelectionMode(QAbstractItemView::NoSelection);
+    stageTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    for (int row = 0; row < stageTable->rowCount(); ++row) {
+        for (int column = 0; column < stageTable->columnCount(); ++column) {
+            QTableWidgetItem* item = new QTableWidgetItem();
+            item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+            stageTable->setItem(row, column, item);
+        }
+    }
+    layout->addWidget(stageTable);
+    
+    QHBoxLayout* buttonLayout = new QHBoxLayout();
+    resetButton = new QPushButton("Reset");
+    closeButton = new QPushButton("Close");
+    buttonLayout->addWidget(resetButton);
+    buttonLayout->addStretch();
+    buttonLayout->addWidget(closeButton);
+    layout->addLayout(buttonLayout);
+    
+    connect(resetButton, &QPushButton::clicked, this, &LatencyDiagnosticsDialog::onResetClicked);
+    connect(closeButton, &QPushButton::clicked, this, &QDialog::close);
+}
+
+void LatencyDiagnosticsDialog::refresh()
+{
+    if (!stats || !isVisible()) {
+        return;
+    }
+    
+    auto ms = [](double us) { return QString::number(us / 1000.0, 'f', 2); };
+    for (int stage = 0; stage < LatencyStats::STAGE_COUNT; ++stage) {
+        LatencyHistogram::Summary summary = stats->histogram(static_cast<LatencyStats::Stage>(stage)).summarize();
+        stageTable->item(stage, 0)->setText(QString::number(summary.count));
+        stageTable->item(stage, 1)->setText(ms(summary.p50Us));
+        stageTable->item(stage, 2)->setText(ms(summary.p90Us));
+        stageTable->item(stage, 3)->setText(ms(summary.p99Us));
+        stageTable->item(stage, 4)->setText(ms(summary.maxUs));
+        stageTable->item(stage, 5)->setText(ms(summary.meanUs));
+    }
+}
+
+void LatencyDiagnosticsDialog::onResetClicked()
+{
+    if (stats) {
+        stats->reset();
+    }
+    refresh();
+}
@@ -17,6 +17,8 @@
 #include <QGroupBox>
 #include <QMessageBox>
 #include <QFont>
+#include <QTableWidget>
+#include <QTimer>
 #include <QSlider>
 #include <memory>
 #include "structures.h"
@@ -24,6 +26,7 @@
 
 // Forward declarations
 class UdpHandler;
+class LatencyStats;
 
 // UDP Configuration Dialog
 class UdpConfigDialog : public QDialog
@@ -39,13 +42,13 @@ public:
 
 signals:
     void connectionStatusChanged(bool connected);
-    void dataReceived(const DetectionData& data);
+    void detectionsReceived(const QVector<DetectionData>& detections);
 
 private slots:
     void connectToHost();
     void disconnectFromHost();
     void onConnectionStatusChanged(bool connected);
-    void onNewDetectionReceived(const DetectionData& detection);
+    void onDetectionsBatchReceived(const QVector<DetectionData>& detections);
     void onErrorOccurred(const QString& error);
     void onStatisticsUpdated(int received, int dropped, double rate);
 
@@ -340,4 +343,26 @@ private:
     void updateAmplificationControls();
 };
 
+// Latency Diagnostics Dialog: live p50/p90/p99/max per ingest stage
+class LatencyDiagnosticsDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit LatencyDiagnosticsDialog(LatencyStats* stats, QWidget* parent = nullptr);
+
+private slots:
+    void refresh();
+    void onResetClicked();
+
+private:
+    LatencyStats* stats;
+    QTableWidget* stageTable;
+    QPushButton* resetButton;
+    QPushButton* closeButton;
+    QTimer* refreshTimer;
+
+    void setupUI();
+};
+
 #endif // DIALOGS_H
\ No newline at end of file
@@ -0,0 +1,101 @@
+#include "hitgrid.h"
+#include <QtGlobal>
+#include <cmath>
+
+// HitGrid Implementation
+HitGrid::HitGrid()
+    : columns(1)
+    , rows(1)
+    , maxHitRadius(0.0)
+{
+    cellStart.assign(2, 0);
+}
+
+void HitGrid::reset(const QSize& area)
+{
+    columns = qMax(1, (area.width() + CELL_SIZE - 1) / CELL_SIZE);
+    rows = qMax(1, (area.height() + CELL_SIZE - 1) / CELL_SIZE);
+    maxHitRadius = 0.0;
+    pending.clear();
+    entries.clear();
+}
+
+void HitGrid::add(const QPointF& center, qreal hitRadius, const TargetDetection& detection)
+{
+    int cell = rowFor(center.y()) * columns + columnFor(center.x());
+    int order = static_cast<int>(pending.size());
+    pending.push_back(Entry{ center, hitRadius, cell, order, detection });
+    maxHitRadius = qMax(maxHitRadius, hitRadius);
+}
+
+void HitGrid::build()
+{
+    // Counting sort by cell keeps each cell's markers contiguous
+    cellStart.assign(static_cast<size_t>(columns) * rows + 1, 0);
+    for (const auto& entry : pending) {
+        cellStart[entry.cell + 1]++;
+    }
+    for (size_t cell = 1; cell < cellStart.size(); ++cell) {
+        cellStart[cell] += cellStart[cell - 1];
+    }
+
+    entries.resize(pending.size());
+    cellFill.assign(cellStart.begin(), cellStart.end() - 1);
+    for (const auto& entry : pending) {
+        entries[cellFill[entry.cell]++] = entry;
+    }
+    pending.clear();
+}
+
+void HitGrid::clear()
+{
+    pending.clear();
+    entries.clear();
+    cellStart.assign(static_cast<size_t>(columns) * rows + 1, 0);
+    maxHitRadius = 0.0;
+}
+
+const TargetDetection* HitGrid::hitAt(const QPointF& point) const
+{
+    if (entries.empty()) {
+        return nullptr;
+    }
+
+    // Only cells within the largest hit radius of the point can hold a hit
+    int firstColumn = columnFor(point.x() - maxHitRadius);
+    int lastColumn = columnFor(point.x() + maxHitRadius);
+    int firstRow = rowFor(point.y() - maxHitRadius);
+    int lastRow = rowFor(point.y() + maxHitRadius);
+
+    const Entry* best = nullptr;
+    qreal bestDistanceSquared = 0.0;
+    for (int row = firstRow; row <= lastRow; ++row) {
+        for (int column = firstColumn; column <= lastColumn; ++column) {
+            int cell = row * columns + column;
+            for (int i = cellStart[cell]; i < cellStart[cell + 1]; ++i) {
+                const Entry& entry = entries[i];
+                qreal dx = point.x() - entry.center.x();
+                qreal dy = point.y() - entry.center.y();
+                qreal distanceSquared = dx * dx + dy * dy;
+                if (distanceSquared > entry.hitRadius * entry.hitRadius) continue;
+
+                if (!best || distanceSquared < bestDistanceSquared ||
+                    (distanceSquared == bestDistanceSquared && entry.order > best->order)) {
+                    best = &entry;
+                    bestDistanceSquared = distanceSquared;
+                }
+            }
+        }
+    }
+    return best ? &best->detection : nullptr;
+}
+
+int HitGrid::columnFor(qreal x) const
+{
+    return qBound(0, static_cast<int>(std::floor(x / CELL_SIZE)), columns - 1);
+}
+
+int HitGrid::rowFor(qreal y) const
+{
+    return qBound(0, static_cast<int>(std::floor(y / CELL_SIZE)), rows - 1);
+}
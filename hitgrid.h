@@ -0,0 +1,56 @@
+#ifndef HITGRID_H
+#define HITGRID_H
+
+#include <QPointF>
+#include <QSize>
+#include <vector>
+#include "structures.h"
+
+// Screen-space index of the markers drawn in the last paint.
+//
+// The chart adds every marker while it paints, at the position it was drawn
+// and with its hit radius, then calls build(). Markers are bucketed into a
+// uniform grid of CELL_SIZE pixel cells, stored contiguously per cell, so a
+// click or hover only examines the few cells within reach of the cursor:
+// O(1) on average, with no trigonometry and no rescan of the tracks.
+class HitGrid
+{
+public:
+    static constexpr int CELL_SIZE = 32;
+
+    HitGrid();
+
+    // Starts a new frame covering a widget of the given size
+    void reset(const QSize& area);
+    void add(const QPointF& center, qreal hitRadius, const TargetDetection& detection);
+    void build();
+    void clear();
+
+    // The marker nearest to point whose hit radius covers it, or nullptr.
+    // Between markers at the same distance the one drawn last (on top) wins.
+    const TargetDetection* hitAt(const QPointF& point) const;
+
+    bool isEmpty() const { return entries.empty(); }
+
+private:
+    struct Entry {
+        QPointF center;
+        qreal hitRadius;
+        int cell;
+        int order;   // drawing order, later markers are on top
+        TargetDetection detection;
+    };
+
+    int columns;
+    int rows;
+    qreal maxHitRadius;
+    std::vector<Entry> pending;     // in drawing order, until build()
+    std::vector<Entry> entries;     // grouped by cell
+    std::vector<int> cellStart;     // columns * rows + 1 offsets into entries
+    std::vector<int> cellFill;      // scratch for build()
+
+    int columnFor(qreal x) const;
+    int rowFor(qreal y) const;
+};
+
+#endif // HITGRID_H
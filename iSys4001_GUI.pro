@@ -6,24 +6,39 @@ CONFIG += c++17
 # Application icon
 # win32:RC_ICONS = app.ico
 
+# Headless core (UdpHandler, parsing, detection storage)
+include(radarcore.pri)
+
 # Header files
 HEADERS += \
-    structures.h \
     isys4001_gui.h \
     mainwindow.h \
     customchart.h \
+    markeratlas.h \
+    detectionrenderer.h \
+    detectionrasterizer.h \
+    persistencemap.h \
+    hitgrid.h \
+    renderscheduler.h \
+    decimation.h \
     dialogs.h \
     targetlist.h \
-    udphandler.h
+    tracktablemodel.h
 
 # Source files
 SOURCES += \
     main_app.cpp \
     mainwindow_basic.cpp \
     customchart.cpp \
+    markeratlas.cpp \
+    detectionrenderer.cpp \
+    detectionrasterizer.cpp \
+    persistencemap.cpp \
+    hitgrid.cpp \
+    renderscheduler.cpp \
     dialogs.cpp \
     targetlist.cpp \
-    udphandler.cpp
+    tracktablemodel.cpp
 
 # Resources
 RESOURCES += resources.qrc
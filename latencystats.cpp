@@ -0,0 +1,131 @@
+#include "latencystats.h"
+#include <QtAlgorithms>
+#include <chrono>
+
+// LatencyHistogram Implementation
+LatencyHistogram::LatencyHistogram()
+    : totalCount(0)
+    , totalUs(0)
+    , maxUs(0)
+{
+    for (auto& bucket : buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+int LatencyHistogram::bucketIndex(qint64 valueUs)
+{
+    if (valueUs < LINEAR_BUCKETS) {
+        return valueUs < 0 ? 0 : static_cast<int>(valueUs);
+    }
+
+    // The top five significant bits select the bucket: sub is in [16, 31]
+    int msb = 63 - qCountLeadingZeroBits(static_cast<quint64>(valueUs));
+    int shift = msb - 4;
+    if (shift > MAX_SHIFT) {
+        return BUCKET_COUNT - 1;
+    }
+    int sub = static_cast<int>(valueUs >> shift);
+    return LINEAR_BUCKETS + (shift - 1) * SUB_BUCKETS + (sub - SUB_BUCKETS);
+}
+
+qint64 LatencyHistogram::bucketUpperBound(int index)
+{
+    if (index < LINEAR_BUCKETS) {
+        return index;
+    }
+    int shift = (index - LINEAR_BUCKETS) / SUB_BUCKETS + 1;
+    qint64 sub = (index - LINEAR_BUCKETS) % SUB_BUCKETS + SUB_BUCKETS;
+    return ((sub + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(qint64 valueUs)
+{
+    record(valueUs, 1);
+}
+
+void LatencyHistogram::record(qint64 valueUs, quint64 count)
+{
+    if (valueUs < 0) {
+        valueUs = 0;
+    }
+
+    buckets[bucketIndex(valueUs)].fetch_add(count, std::memory_order_relaxed);
+    totalCount.fetch_add(count, std::memory_order_relaxed);
+    totalUs.fetch_add(valueUs * static_cast<qint64>(count), std::memory_order_relaxed);
+
+    qint64 currentMax = maxUs.load(std::memory_order_relaxed);
+    while (valueUs > currentMax &&
+           !maxUs.compare_exchange_weak(currentMax, valueUs, std::memory_order_relaxed)) {
+    }
+}
+
+LatencyHistogram::Summary LatencyHistogram::summarize() const
+{
+    std::array<quint64, BUCKET_COUNT> counts;
+    quint64 count = 0;
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        counts[i] = buckets[i].load(std::memory_order_relaxed);
+        count += counts[i];
+    }
+
+    Summary summary;
+    summary.count = count;
+    if (count == 0) {
+        return summary;
+    }
+
+    summary.maxUs = maxUs.load(std::memory_order_relaxed);
+    summary.meanUs = static_cast<double>(totalUs.load(std::memory_order_relaxed)) /
+                     qMax<quint64>(totalCount.load(std::memory_order_relaxed), 1);
+
+    // Percentiles report the bucket's upper bound, but never more than the observed max
+    const double percentiles[] = { 50.0, 90.0, 99.0 };
+    qint64* results[] = { &summary.p50Us, &summary.p90Us, &summary.p99Us };
+    quint64 seen = 0;
+    int next = 0;
+    for (int i = 0; i < BUCKET_COUNT && next < 3; ++i) {
+        seen += counts[i];
+        while (next < 3 && seen * 100.0 >= percentiles[next] * count) {
+            *results[next] = qMin(bucketUpperBound(i), summary.maxUs);
+            next++;
+        }
+    }
+    return summary;
+}
+
+void LatencyHistogram::reset()
+{
+    for (auto& bucket : buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    totalCount.store(0, std::memory_order_relaxed);
+    totalUs.store(0, std::memory_order_relaxed);
+    maxUs.store(0, std::memory_order_relaxed);
+}
+
+// LatencyStats Implementation
+const char* LatencyStats::stageName(Stage stage)
+{
+    switch (stage) {
+    case ParseStage:   return "Parse";
+    case StoreStage:   return "Store";
+    case DeliverStage: return "Deliver";
+    case PaintStage:   return "Paint";
+    case STAGE_COUNT:  break;
+    }
+    return "";
+}
+
+qint64 LatencyStats::nowUs()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void LatencyStats::reset()
+{
+    for (auto& histogram : histograms) {
+        histogram.reset();
+    }
+}
@@ -0,0 +1,103 @@
+#ifndef LATENCYSTATS_H
+#define LATENCYSTATS_H
+
+#include <QtGlobal>
+#include <array>
+#include <atomic>
+
+// Log-linear latency histogram in the style of HdrHistogram. Values below
+// 32 us get a bucket each; above that, every power of two is split into 16
+// linear sub-buckets, so a reported percentile is within ~6% of the true
+// value from microseconds up to hours. record() is a handful of relaxed
+// atomic adds and may be called from any thread without locking.
+class LatencyHistogram
+{
+public:
+    struct Summary {
+        quint64 count = 0;
+        qint64 p50Us = 0;
+        qint64 p90Us = 0;
+        qint64 p99Us = 0;
+        qint64 maxUs = 0;
+        double meanUs = 0.0;
+    };
+
+    LatencyHistogram();
+
+    void record(qint64 valueUs);
+    void record(qint64 valueUs, quint64 count);
+
+    // Buckets are read one by one while writers may still be adding, so a
+    // summary taken under load is approximate but never torn per bucket
+    Summary summarize() const;
+    void reset();
+
+private:
+    static constexpr int LINEAR_BUCKETS = 32;
+    static constexpr int SUB_BUCKETS = 16;
+    static constexpr int MAX_SHIFT = 32;   // values are clamped to ~19 hours
+    static constexpr int BUCKET_COUNT = LINEAR_BUCKETS + MAX_SHIFT * SUB_BUCKETS;
+
+    std::array<std::atomic<quint64>, BUCKET_COUNT> buckets;
+    std::atomic<quint64> totalCount;
+    std::atomic<qint64> totalUs;
+    std::atomic<qint64> maxUs;
+
+    static int bucketIndex(qint64 valueUs);
+    static qint64 bucketUpperBound(int index);
+};
+
+// Per-stage age of detections on their way from the socket to the screen.
+// Every stage records the time elapsed since the datagram carrying the
+// detection was received (DetectionData::receive_time_us), so each
+// histogram answers "how old is a detection by the time it gets here".
+class LatencyStats
+{
+public:
+    enum Stage {
+        ParseStage,     // parsed into DetectionData
+        StoreStage,     // inserted into UdpHandler's detection store
+        DeliverStage,   // delivered to MainWindow::processDetections
+        PaintStage,     // first painted by the detection chart
+        STAGE_COUNT
+    };
+
+    static const char* stageName(Stage stage);
+
+    // Monotonic clock for receive_time_us; not related to wall-clock timestamps
+    static qint64 nowUs();
+
+    // count detections that were received at receiveTimeUs and reached stage at stageTimeUs
+    void record(Stage stage, qint64 receiveTimeUs, qint64 stageTimeUs, quint64 count = 1)
+    {
+        if (receiveTimeUs > 0 && count > 0) {
+            histograms[stage].record(stageTimeUs - receiveTimeUs, count);
+        }
+    }
+
+    // Records a batch of detections with one clock read. Detections from the
+    // same datagram share a receive time and are recorded as one weighted sample.
+    template <typename Container>
+    void recordBatch(Stage stage, const Container& detections, qint64 stageTimeUs)
+    {
+        qint64 runTimeUs = 0;
+        quint64 runLength = 0;
+        for (const auto& detection : detections) {
+            if (detection.receive_time_us != runTimeUs) {
+                record(stage, runTimeUs, stageTimeUs, runLength);
+                runTimeUs = detection.receive_time_us;
+                runLength = 0;
+            }
+            runLength++;
+        }
+        record(stage, runTimeUs, stageTimeUs, runLength);
+    }
+
+    const LatencyHistogram& histogram(Stage stage) const { return histograms[stage]; }
+    void reset();
+
+private:
+    std::array<LatencyHistogram, STAGE_COUNT> histograms;
+};
+
+#endif // LATENCYSTATS_H
@@ -20,8 +20,10 @@
 #include <QFileDialog>
 #include <QMessageBox>
 #include <QTimer>
-#include <QTableWidget>
+#include <QTableView>
+#include <QSortFilterProxyModel>
 #include <QMutex>
+#include <QActionGroup>
 #include <memory>
 
 #include "structures.h"
@@ -29,6 +31,12 @@
 #include "targetlist.h"
 #include "dialogs.h"
 #include "udphandler.h"
+#include "tracktablemodel.h"
+#include "capturerecorder.h"
+#include "capturereplay.h"
+#include "latencystats.h"
+#include "trackstore.h"
+#include "renderscheduler.h"
 
 class MainWindow : public QMainWindow
 {
@@ -50,6 +58,11 @@ private slots:
     void showAngleCorrectionDialog();
     void showAmplificationDialog();
     void showDSPSettingsDialog();
+    void showLatencyDiagnostics();
+    void toggleCaptureRecording();
+    void replayCapture();
+    void jumpToCaptureTime();
+    void onCaptureReplayFinished();
     
     // Control actions
     void toggleLiveStream();
@@ -61,10 +74,15 @@ private slots:
     void onAmplificationChanged(int value);
     void onChannelChanged(int index);
     void onLineFilterChanged();
+    void onSmoothTracksToggled(bool enabled);
+    void onAssociateTargetsToggled(bool enabled);
+    void onRenderRateSelected(QAction* action);
+    void onSyncToDisplayToggled(bool enabled);
+    void onThreadedRenderingToggled(bool enabled);
     
     // UDP data handling
     void onUdpConnectionChanged(bool connected);
-    void onNewDetectionReceived(const DetectionData& detection);
+    void onDetectionsReceived(const QVector<DetectionData>& detections);
     void onUdpStatisticsUpdated(int received, int dropped, double rate);
     void onTargetSelected(const TargetDetection& target);
     void onChartDetectionClicked(const TargetDetection& target);
@@ -76,6 +94,8 @@ private slots:
     
     // Zoom handling
     void onZoomChanged(double zoomLevel);
+    void onDetectionDisplayModeChanged(int index);
+    void onPersistenceChanged(int index);
     
     // DSP Settings
     void onSendDSPSettings(const DSP_Settings_t& settings);
@@ -87,6 +107,7 @@ private:
     void setupUI();
     void setupStatusBar();
     void setupConnections();
+    UdpHandler* ensureUdpHandler();
     
     // Tab creation
     QWidget* createRawSignalTab();
@@ -99,7 +120,7 @@ private:
     void applySettings();
     
     // Data processing
-    void processDetection(const DetectionData& detection);
+    void processDetections(const QVector<DetectionData>& detections);
     void updateDetectionCharts();
     void updateTargetLists();
     
@@ -130,11 +151,15 @@ private:
     QCheckBox* filter100Hz;
     QCheckBox* filter150Hz;
     
-    // Zoom controls
+    // Zoom and display controls
     QLabel* zoomLevelLabel;
+    QComboBox* displayModeCombo;
+    QComboBox* persistenceCombo;
     
     // Track table for detection tab
-    QTableWidget* trackTable;
+    QTableView* trackTable;
+    TrackTableModel* trackModel;
+    QSortFilterProxyModel* trackProxyModel;
     
     // Target lists
     std::vector<TargetListWidget*> targetLists;
@@ -143,6 +168,12 @@ private:
     QLabel* connectionStatusLabel;
     QLabel* dataRateLabel;
     QLabel* targetCountLabel;
+    QLabel* paintTimeLabel;
+    QLabel* frameStatsLabel;
+    QLabel* latencyLabel;
+    
+    // Socket-to-pixel latency; declared before the dialogs so it outlives the UDP handler
+    LatencyStats latencyStats;
     
     // Dialogs
     std::unique_ptr<UdpConfigDialog> udpConfigDialog;
@@ -150,10 +181,24 @@ private:
     std::unique_ptr<AngleCorrectionDialog> angleDialog;
     std::unique_ptr<AmplificationDialog> amplificationDialog;
     std::unique_ptr<DSPSettingsDialog> dspSettingsDialog;
+    std::unique_ptr<LatencyDiagnosticsDialog> latencyDialog;
+    
+    // Raw datagram capture and replay
+    std::unique_ptr<CaptureRecorder> captureRecorder;
+    std::unique_ptr<CaptureReplay> captureReplay;
+    QAction* recordCaptureAction;
+    QAction* jumpToTimeAction;
+    QAction* smoothTracksAction;
+    QAction* associateTargetsAction;
+    QActionGroup* renderRateGroup;
+    QAction* syncToDisplayAction;
+    QAction* threadedRenderingAction;
+    
+    // Paces all chart repaints and track table flushes; created before the charts
+    RenderScheduler* renderScheduler;
     
     // Data management
-    std::vector<DetectionData> recentDetections;
-    mutable QMutex recentDetectionsMutex;
+    TrackStore liveTracks;   // one entry per target_id seen within TRACK_TIMEOUT_MS
     QTimer* updateTimer;
     
     // State
@@ -170,23 +215,32 @@ private:
         bool filter100Hz;
         bool filter150Hz;
         bool autoAmplification;
+        bool smoothTracks;
+        bool associateTargets;
+        int renderRateHz;
+        bool syncToDisplay;
+        bool threadedRendering;
+        int detectionDisplayMode;
+        int persistenceMs;
         
         AppConfig() : threshold(0), amplification(20), channel(0), 
                      filter50Hz(false), filter100Hz(false), filter150Hz(false),
-                     autoAmplification(false) {}
+                     autoAmplification(false), smoothTracks(false), associateTargets(false),
+                     renderRateHz(60), syncToDisplay(true), threadedRendering(false),
+                     detectionDisplayMode(CustomChart::TrackDisplay),
+                     persistenceMs(PersistenceMap::DEFAULT_PERSISTENCE_MS) {}
     } config;
     
     // Helper methods
     void updateConnectionStatus(bool connected);
     void updateDataRate(double rate);
     void updateTargetCount(int count);
-    void updateTrackTable();
     void showDetectionInChart(const DetectionData& detection);
     void highlightTargetInChart(const TargetDetection& target);
     
     // Constants
     static constexpr int UPDATE_INTERVAL_MS = 100;
-    static constexpr int MAX_RECENT_DETECTIONS = 1000;
+    static constexpr int TRACK_TIMEOUT_MS = 10000;
 };
 
 #endif // MAINWINDOW_H
\ No newline at end of file
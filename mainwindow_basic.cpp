@@ -1,8 +1,19 @@
 #include "mainwindow.h"
 #include <QFile>
+#include <QFileInfo>
+#include <QInputDialog>
+#include "detectionrasterizer.h"
 
 MainWindow::MainWindow(QWidget* parent)
     : QMainWindow(parent)
+    , recordCaptureAction(nullptr)
+    , jumpToTimeAction(nullptr)
+    , smoothTracksAction(nullptr)
+    , associateTargetsAction(nullptr)
+    , renderRateGroup(nullptr)
+    , syncToDisplayAction(nullptr)
+    , threadedRenderingAction(nullptr)
+    , renderScheduler(nullptr)
     , liveStreamActive(false)
     , frozen(false)
     , connected(false)
@@ -24,6 +35,8 @@ MainWindow::MainWindow(QWidget* parent)
         styleFile.close();
     }
     
+    renderScheduler = new RenderScheduler(this);
+    
     setupMenuBar();
     setupUI();
     setupStatusBar();
@@ -41,6 +54,15 @@ MainWindow::MainWindow(QWidget* parent)
 MainWindow::~MainWindow()
 {
     saveSettings();
+    
+    // Detach capture before the UDP handler's receive thread goes away
+    captureReplay.reset();
+    if (captureRecorder) {
+        if (udpConfigDialog && udpConfigDialog->getUdpHandler()) {
+            udpConfigDialog->getUdpHandler()->setCaptureRecorder(nullptr);
+        }
+        captureRecorder->stop();
+    }
 }
 
 void MainWindow::setupMenuBar()
@@ -52,6 +74,11 @@ void MainWindow::setupMenuBar()
     fileMenu->addAction("Save configuration to file", this, &MainWindow::saveConfiguration);
     fileMenu->addAction("Load configuration from file", this, &MainWindow::loadConfiguration);
     fileMenu->addSeparator();
+    recordCaptureAction = fileMenu->addAction("Record UDP capture...", this, &MainWindow::toggleCaptureRecording);
+    fileMenu->addAction("Replay UDP capture...", this, &MainWindow::replayCapture);
+    jumpToTimeAction = fileMenu->addAction("Jump to capture time...", this, &MainWindow::jumpToCaptureTime);
+    jumpToTimeAction->setEnabled(false);
+    fileMenu->addSeparator();
     fileMenu->addAction("Exit", this, &QWidget::close);
     
     // iSYS menu
@@ -63,10 +90,39 @@ void MainWindow::setupMenuBar()
     QMenu* configMenu = menuBar->addMenu("Config");
     configMenu->addAction("Amplification Settings", this, &MainWindow::showAmplificationDialog);
     configMenu->addAction("Angle Correction", this, &MainWindow::showAngleCorrectionDialog);
+    configMenu->addSeparator();
+    smoothTracksAction = configMenu->addAction("Smooth Tracks (Kalman)");
+    smoothTracksAction->setCheckable(true);
+    connect(smoothTracksAction, &QAction::toggled, this, &MainWindow::onSmoothTracksToggled);
+    associateTargetsAction = configMenu->addAction("Associate Targets (ignore sensor IDs)");
+    associateTargetsAction->setCheckable(true);
+    connect(associateTargetsAction, &QAction::toggled, this, &MainWindow::onAssociateTargetsToggled);
+    configMenu->addSeparator();
+    QMenu* renderRateMenu = configMenu->addMenu("Render Rate");
+    renderRateGroup = new QActionGroup(this);
+    for (int rateHz : { 30, 60, 120 }) {
+        QAction* rateAction = renderRateMenu->addAction(QString("%1 Hz").arg(rateHz));
+        rateAction->setCheckable(true);
+        rateAction->setData(rateHz);
+        renderRateGroup->addAction(rateAction);
+    }
+    connect(renderRateGroup, &QActionGroup::triggered, this, &MainWindow::onRenderRateSelected);
+    renderRateMenu->addSeparator();
+    syncToDisplayAction = renderRateMenu->addAction("Sync to Display Refresh");
+    syncToDisplayAction->setCheckable(true);
+    syncToDisplayAction->setChecked(true);
+    connect(syncToDisplayAction, &QAction::toggled, this, &MainWindow::onSyncToDisplayToggled);
+    threadedRenderingAction = configMenu->addAction("Render Plot on Worker Thread");
+    threadedRenderingAction->setCheckable(true);
+    connect(threadedRenderingAction, &QAction::toggled, this, &MainWindow::onThreadedRenderingToggled);
     
     // DSP Settings menu
     QMenu* dspMenu = menuBar->addMenu("DSP");
     dspMenu->addAction("DSP Settings...", this, &MainWindow::showDSPSettingsDialog);
+    
+    // Diagnostics menu
+    QMenu* diagnosticsMenu = menuBar->addMenu("Diagnostics");
+    diagnosticsMenu->addAction("Latency...", this, &MainWindow::showLatencyDiagnostics);
 }
 
 void MainWindow::setupUI()
@@ -101,6 +157,7 @@ void MainWindow::setupUI()
     
     // Raw Signal tab
     rawChart = new CustomChart(CustomChart::RAW_SIGNAL_CHART);
+    rawChart->setRenderScheduler(renderScheduler);
     mainTabs->addTab(rawChart, "Raw Signal");
     
     // Detection tab
@@ -185,11 +242,14 @@ QWidget* MainWindow::createDetectionTab()
     
     // FFT Chart for frequency analysis (smaller size)
     fftChart = new CustomChart(CustomChart::FFT_CHART);
+    fftChart->setRenderScheduler(renderScheduler);
     fftChart->setMaximumHeight(150);  // Limit FFT chart height
     chartLayout->addWidget(fftChart);
     
     // Detection Chart for showing detected targets on polar plot - Full size
     detectionChart = new CustomChart(CustomChart::DETECTION_CHART);
+    detectionChart->setLatencyStats(&latencyStats);
+    detectionChart->setRenderScheduler(renderScheduler);
     chartLayout->addWidget(detectionChart);
     
     // Zoom controls for detection chart
@@ -206,6 +266,24 @@ QWidget* MainWindow::createDetectionTab()
     zoomLayout->addWidget(zoomOutBtn);
     zoomLayout->addWidget(resetZoomBtn);
     zoomLayout->addWidget(zoomLevelLabel);
+    
+    // Live tracks, the afterglow of recent traffic, or both
+    displayModeCombo = new QComboBox();
+    displayModeCombo->addItem("Tracks", CustomChart::TrackDisplay);
+    displayModeCombo->addItem("Afterglow", CustomChart::PersistenceDisplay);
+    displayModeCombo->addItem("Tracks + Afterglow", CustomChart::TrackAndPersistenceDisplay);
+    persistenceCombo = new QComboBox();
+    for (int seconds : { 30, 60, 120, 300 }) {
+        QString text = seconds < 60 ? QString("%1 s").arg(seconds) : QString("%1 min").arg(seconds / 60);
+        persistenceCombo->addItem(text, seconds * 1000);
+    }
+    persistenceCombo->setCurrentIndex(persistenceCombo->findData(PersistenceMap::DEFAULT_PERSISTENCE_MS));
+    
+    zoomLayout->addSpacing(20);
+    zoomLayout->addWidget(new QLabel("Display:"));
+    zoomLayout->addWidget(displayModeCombo);
+    zoomLayout->addWidget(new QLabel("Afterglow:"));
+    zoomLayout->addWidget(persistenceCombo);
     zoomLayout->addStretch();
     
     // Connect zoom buttons
@@ -213,6 +291,10 @@ QWidget* MainWindow::createDetectionTab()
     connect(zoomOutBtn, &QPushButton::clicked, detectionChart, &CustomChart::zoomOut);
     connect(resetZoomBtn, &QPushButton::clicked, detectionChart, &CustomChart::resetZoom);
     connect(detectionChart, &CustomChart::zoomChanged, this, &MainWindow::onZoomChanged);
+    connect(displayModeCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &MainWindow::onDetectionDisplayModeChanged);
+    connect(persistenceCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &MainWindow::onPersistenceChanged);
     
     chartLayout->addWidget(zoomGroup);
     detectionLayout->addWidget(chartWidget, 3);  // Give more space to chart
@@ -225,11 +307,15 @@ QWidget* MainWindow::createDetectionTab()
     QGroupBox* trackGroup = new QGroupBox("Track Table");
     QVBoxLayout* trackLayout = new QVBoxLayout(trackGroup);
     
-    // Create track table
-    trackTable = new QTableWidget();
-    trackTable->setColumnCount(4);
-    QStringList headers = {"Track ID", "Radius (m)", "Radial Speed (m/s)", "Azimuth (°)"};
-    trackTable->setHorizontalHeaderLabels(headers);
+    // Create track table: one row per track, updated incrementally by the model
+    trackModel = new TrackTableModel(this);
+    trackModel->setRenderScheduler(renderScheduler);
+    trackProxyModel = new QSortFilterProxyModel(this);
+    trackProxyModel->setSourceModel(trackModel);
+    trackProxyModel->setSortRole(TrackTableModel::SortRole);
+    
+    trackTable = new QTableView();
+    trackTable->setModel(trackProxyModel);
     trackTable->setAlternatingRowColors(true);
     trackTable->setSelectionBehavior(QAbstractItemView::SelectRows);
     trackTable->setSortingEnabled(true);
@@ -295,6 +381,7 @@ QWidget* MainWindow::createOutputTab(int outputNumber)
     
     // Detection chart for this output
     CustomChart* detectionChart = new CustomChart(CustomChart::DETECTION_CHART);
+    detectionChart->setRenderScheduler(renderScheduler);
     outputCharts.push_back(detectionChart);
     splitter->addWidget(detectionChart);
     
@@ -318,6 +405,18 @@ void MainWindow::setupStatusBar()
     
     targetCountLabel = new QLabel("Targets: 0");
     statusBar->addPermanentWidget(targetCountLabel);
+    
+    paintTimeLabel = new QLabel("Paint: 0.0 ms");
+    paintTimeLabel->setToolTip("Average detection chart paint time");
+    statusBar->addPermanentWidget(paintTimeLabel);
+    
+    frameStatsLabel = new QLabel("Frames: - fps");
+    frameStatsLabel->setToolTip("Render frame rate, and frames dropped or started late since launch");
+    statusBar->addPermanentWidget(frameStatsLabel);
+    
+    latencyLabel = new QLabel("Latency p50/p99/max: - ms");
+    latencyLabel->setToolTip("Age of detections when first painted, from datagram receipt");
+    statusBar->addPermanentWidget(latencyLabel);
 }
 
 void MainWindow::setupConnections()
@@ -357,7 +456,8 @@ void MainWindow::setupConnections()
     
     // Track table connections
     if (trackTable) {
-        connect(trackTable, &QTableWidget::itemSelectionChanged, this, &MainWindow::onTrackTableSelectionChanged);
+        connect(trackTable->selectionModel(), &QItemSelectionModel::selectionChanged,
+                this, &MainWindow::onTrackTableSelectionChanged);
     }
 }
 
@@ -393,6 +493,12 @@ void MainWindow::loadConfiguration()
 }
 
 void MainWindow::showUdpConfigDialog()
+{
+    ensureUdpHandler();
+    udpConfigDialog->exec();
+}
+
+UdpHandler* MainWindow::ensureUdpHandler()
 {
     if (!udpConfigDialog) {
         udpConfigDialog = std::make_unique<UdpConfigDialog>(this);
@@ -400,17 +506,145 @@ void MainWindow::showUdpConfigDialog()
         // Connect UDP signals from dialog
         connect(udpConfigDialog.get(), &UdpConfigDialog::connectionStatusChanged, 
                 this, &MainWindow::onUdpConnectionChanged);
-        connect(udpConfigDialog.get(), &UdpConfigDialog::dataReceived, 
-                this, &MainWindow::onNewDetectionReceived);
+        connect(udpConfigDialog.get(), &UdpConfigDialog::detectionsReceived, 
+                this, &MainWindow::onDetectionsReceived);
         
         // Connect UDP statistics from the UDP handler directly
         if (udpConfigDialog->getUdpHandler()) {
             connect(udpConfigDialog->getUdpHandler(), &UdpHandler::statisticsUpdated,
                     this, &MainWindow::onUdpStatisticsUpdated);
+            udpConfigDialog->getUdpHandler()->setLatencyStats(&latencyStats);
         }
     }
+    return udpConfigDialog->getUdpHandler();
+}
+
+void MainWindow::toggleCaptureRecording()
+{
+    UdpHandler* handler = ensureUdpHandler();
+    
+    if (captureRecorder && captureRecorder->isRecording()) {
+        handler->setCaptureRecorder(nullptr);
+        captureRecorder->stop();
+        recordCaptureAction->setText("Record UDP capture...");
+        statusBar()->showMessage(QString("Capture saved: %1 datagrams, %2 dropped")
+                                 .arg(captureRecorder->getDatagramsRecorded())
+                                 .arg(captureRecorder->getDatagramsDropped()), 5000);
+        return;
+    }
     
-    udpConfigDialog->exec();
+    QString fileName = QFileDialog::getSaveFileName(this, "Record UDP Capture", "", "Radar Captures (*.rcap)");
+    if (fileName.isEmpty()) {
+        return;
+    }
+    
+    if (!captureRecorder) {
+        captureRecorder = std::make_unique<CaptureRecorder>();
+        connect(captureRecorder.get(), &CaptureRecorder::errorOccurred, this, [this](const QString& error) {
+            ensureUdpHandler()->setCaptureRecorder(nullptr);
+            recordCaptureAction->setText("Record UDP capture...");
+            QMessageBox::warning(this, "Capture", error);
+        });
+    }
+    
+    QString error;
+    if (!captureRecorder->start(fileName, &error)) {
+        QMessageBox::warning(this, "Capture", QString("Cannot start recording: %1").arg(error));
+        return;
+    }
+    handler->setCaptureRecorder(captureRecorder.get());
+    recordCaptureAction->setText("Stop UDP capture");
+}
+
+void MainWindow::replayCapture()
+{
+    QString fileName = QFileDialog::getOpenFileName(this, "Replay UDP Capture", "", "Radar Captures (*.rcap)");
+    if (fileName.isEmpty()) {
+        return;
+    }
+    
+    QStringList speeds = { "1x", "2x", "5x", "10x", "Max" };
+    bool ok = false;
+    QString speed = QInputDialog::getItem(this, "Replay Speed", "Speed:", speeds, 0, false, &ok);
+    if (!ok) {
+        return;
+    }
+    
+    if (!captureReplay) {
+        captureReplay = std::make_unique<CaptureReplay>(ensureUdpHandler());
+        connect(captureReplay.get(), &CaptureReplay::finished, this, &MainWindow::onCaptureReplayFinished);
+        connect(captureReplay.get(), &CaptureReplay::errorOccurred, this, [this](const QString& error) {
+            QMessageBox::warning(this, "Replay", error);
+        });
+    }
+    
+    QString error;
+    if (!captureReplay->open(fileName, &error)) {
+        QMessageBox::warning(this, "Replay", QString("Cannot open capture: %1").arg(error));
+        return;
+    }
+    
+    captureReplay->setSpeed(speed == "Max" ? 0.0 : speed.chopped(1).toDouble());
+    captureReplay->start();
+    jumpToTimeAction->setEnabled(true);
+    statusBar()->showMessage(QString("Replaying %1 at %2").arg(QFileInfo(fileName).fileName(), speed));
+}
+
+void MainWindow::jumpToCaptureTime()
+{
+    if (!captureReplay) {
+        return;
+    }
+    
+    QDateTime start = QDateTime::fromMSecsSinceEpoch(captureReplay->getStartTimeUs() / 1000);
+    QDateTime end = QDateTime::fromMSecsSinceEpoch(captureReplay->getEndTimeUs() / 1000);
+    QDateTime current = QDateTime::fromMSecsSinceEpoch(captureReplay->getCurrentTimeUs() / 1000);
+    
+    bool ok = false;
+    QString text = QInputDialog::getText(this, "Jump to Capture Time",
+                                         QString("Time (hh:mm:ss), capture runs %1 - %2:")
+                                         .arg(start.toString("HH:mm:ss"), end.toString("HH:mm:ss")),
+                                         QLineEdit::Normal, current.toString("HH:mm:ss"), &ok);
+    if (!ok) {
+        return;
+    }
+    
+    QTime time = QTime::fromString(text.trimmed(), "H:mm:ss");
+    if (!time.isValid()) {
+        QMessageBox::warning(this, "Replay", QString("Invalid time: %1").arg(text));
+        return;
+    }
+    
+    // Time of day on the capture's first day, or the next day for captures past midnight
+    QDateTime target(start.date(), time);
+    if (target < start) {
+        target = target.addDays(1);
+    }
+    
+    // Start rendering afresh from the new position
+    ensureUdpHandler()->clearDetections();
+    liveTracks.clear();
+    if (detectionChart) {
+        detectionChart->clearDetections();
+    }
+    trackModel->clear();
+    updateTargetCount(0);
+    
+    bool wasRunning = captureReplay->isRunning();
+    if (!captureReplay->seek(target.toMSecsSinceEpoch() * 1000)) {
+        statusBar()->showMessage("Capture ends before that time", 5000);
+        return;
+    }
+    if (!wasRunning) {
+        captureReplay->start();
+    }
+    statusBar()->showMessage(QString("Replay at %1").arg(target.toString("HH:mm:ss")), 5000);
+}
+
+void MainWindow::onCaptureReplayFinished()
+{
+    statusBar()->showMessage(QString("Replay finished: %1 datagrams")
+                             .arg(captureReplay->getDatagramsReplayed()), 5000);
 }
 
 void MainWindow::showOutputConfigDialog()
@@ -451,6 +685,16 @@ void MainWindow::showDSPSettingsDialog()
     dspSettingsDialog->exec();
 }
 
+void MainWindow::showLatencyDiagnostics()
+{
+    if (!latencyDialog) {
+        latencyDialog = std::make_unique<LatencyDiagnosticsDialog>(&latencyStats, this);
+    }
+    latencyDialog->show();
+    latencyDialog->raise();
+    latencyDialog->activateWindow();
+}
+
 void MainWindow::onSendDSPSettings(const DSP_Settings_t& settings)
 {
     // Check if we have a UDP connection
@@ -556,15 +800,66 @@ void MainWindow::onLineFilterChanged()
     config.filter150Hz = filter150Hz->isChecked();
 }
 
+void MainWindow::onAssociateTargetsToggled(bool enabled)
+{
+    config.associateTargets = enabled;
+    ensureUdpHandler()->setIdAssociation(enabled);
+}
+
+void MainWindow::onRenderRateSelected(QAction* action)
+{
+    config.renderRateHz = action->data().toInt();
+    renderScheduler->setTargetRate(config.renderRateHz);
+}
+
+void MainWindow::onSyncToDisplayToggled(bool enabled)
+{
+    config.syncToDisplay = enabled;
+    renderScheduler->setSyncToDisplay(enabled);
+}
+
+void MainWindow::onThreadedRenderingToggled(bool enabled)
+{
+    config.threadedRendering = enabled;
+    if (detectionChart) {
+        detectionChart->setThreadedRendering(enabled);
+    }
+}
+
+void MainWindow::onDetectionDisplayModeChanged(int index)
+{
+    config.detectionDisplayMode = displayModeCombo->itemData(index).toInt();
+    if (detectionChart) {
+        detectionChart->setDetectionDisplayMode(
+            static_cast<CustomChart::DetectionDisplayMode>(config.detectionDisplayMode));
+    }
+}
+
+void MainWindow::onPersistenceChanged(int index)
+{
+    config.persistenceMs = persistenceCombo->itemData(index).toInt();
+    if (detectionChart) {
+        detectionChart->setPersistence(config.persistenceMs);
+    }
+}
+
+void MainWindow::onSmoothTracksToggled(bool enabled)
+{
+    config.smoothTracks = enabled;
+    if (detectionChart) {
+        detectionChart->setSmoothing(enabled);
+    }
+}
+
 void MainWindow::onUdpConnectionChanged(bool connected)
 {
     this->connected = connected;
     updateConnectionStatus(connected);
 }
 
-void MainWindow::onNewDetectionReceived(const DetectionData& detection)
+void MainWindow::onDetectionsReceived(const QVector<DetectionData>& detections)
 {
-    processDetection(detection);
+    processDetections(detections);
 }
 
 void MainWindow::onUdpStatisticsUpdated(int received, int dropped, double rate)
@@ -597,54 +892,73 @@ void MainWindow::updateStatus()
 {
     // Update various status indicators
     statusBar()->showMessage(QString("Ready - %1").arg(connected ? "Connected" : "Not Connected"));
+    
+    if (detectionChart) {
+        QString paintText = QString("Paint: %1 ms").arg(detectionChart->getAveragePaintTimeMs(), 0, 'f', 2);
+        if (const DetectionRasterizer* rasterizer = detectionChart->getRasterizer()) {
+            paintText += QString(" (worker %1 ms)").arg(rasterizer->statistics().averageRenderMs, 0, 'f', 2);
+        }
+        paintTimeLabel->setText(paintText);
+    }
+    
+    const RenderScheduler::Statistics& frames = renderScheduler->statistics();
+    frameStatsLabel->setText(QString("Frames: %1 fps, %2 dropped, %3 late")
+                             .arg(frames.frameRate, 0, 'f', 1)
+                             .arg(frames.droppedFrames)
+                             .arg(frames.lateFrames));
+    
+    // Tracks that went quiet drop out of the count even when no data arrives
+    if (liveTracks.expire(QDateTime::currentMSecsSinceEpoch() - TRACK_TIMEOUT_MS) > 0) {
+        updateTargetCount(liveTracks.size());
+    }
+    
+    LatencyHistogram::Summary latency = latencyStats.histogram(LatencyStats::PaintStage).summarize();
+    if (latency.count > 0) {
+        latencyLabel->setText(QString("Latency p50/p99/max: %1 / %2 / %3 ms")
+                              .arg(latency.p50Us / 1000.0, 0, 'f', 1)
+                              .arg(latency.p99Us / 1000.0, 0, 'f', 1)
+                              .arg(latency.maxUs / 1000.0, 0, 'f', 1));
+    }
 }
 
-void MainWindow::processDetection(const DetectionData& detection)
+void MainWindow::processDetections(const QVector<DetectionData>& detections)
 {
-    //qDebug()<<"processDetection";
-    // Add to recent detections
-    {
-        QMutexLocker locker(&recentDetectionsMutex);
-        recentDetections.push_back(detection);
-        if (recentDetections.size() > MAX_RECENT_DETECTIONS) {
-            recentDetections.erase(recentDetections.begin());
-        }
-    }
+    //qDebug()<<"processDetections";
+    if (detections.isEmpty()) return;
+    
+    latencyStats.recordBatch(LatencyStats::DeliverStage, detections, LatencyStats::nowUs());
+    
+    // Fold the batch into the live tracks
+    liveTracks.updateBatch(detections, QDateTime::currentMSecsSinceEpoch());
     
     // Update target lists (commented out since output targets are not used now)
     /*
     for (auto* targetList : targetLists) {
-        targetList->onNewDetection(detection);
+        targetList->onNewDetections(detections);
     }
     */
     
-    // Update charts - Convert DetectionData to TargetDetection
-    TargetDetection target = detection.toTargetDetection();
-    
-    // Update FFT chart
-    if (fftChart && !frozen) {
-        fftChart->addDetection(target);
-    }
-    
     // Update main detection chart in detection tab
     if (detectionChart && !frozen) {
-        detectionChart->addDetection(target);
+        detectionChart->addDetections(detections);
     }
     
     // Update output charts (commented out since outputs are not used now)
     /*
     for (auto* chart : outputCharts) {
         if (!frozen) {
-            chart->addDetection(target);
+            chart->addDetections(detections);
         }
     }
     */
     
-    // Update track table
-    updateTrackTable();
+    // Update track table (applied at the next display refresh)
+    if (trackModel) {
+        trackModel->updateDetections(detections);
+    }
     
     // Update target count in status bar
-    updateTargetCount(static_cast<int>(recentDetections.size()));
+    updateTargetCount(liveTracks.size());
 }
 
 void MainWindow::updateConnectionStatus(bool connected)
@@ -668,58 +982,6 @@ void MainWindow::updateTargetCount(int count)
     targetCountLabel->setText(QString("Targets: %1").arg(count));
 }
 
-void MainWindow::updateTrackTable()
-{
-    if (!trackTable) return;
-    
-    // Clear existing rows
-    trackTable->setRowCount(0);
-    
-    // Add recent detections to the table
-    QMutexLocker locker(&recentDetectionsMutex);
-    int row = 0;
-    for (const auto& detection : recentDetections) {
-        // Only show recent detections (last 10 seconds)
-        qint64 currentTime = QDateTime::currentMSecsSinceEpoch();
-        if (currentTime - detection.timestamp > 10000) continue;  // Skip old detections
-        
-        trackTable->insertRow(row);
-        
-        // Track ID
-        QTableWidgetItem* idItem = new QTableWidgetItem(QString::number(detection.target_id));
-        idItem->setTextAlignment(Qt::AlignCenter);
-        trackTable->setItem(row, 0, idItem);
-        
-        // Radius
-        QTableWidgetItem* radiusItem = new QTableWidgetItem(QString::number(detection.radius, 'f', 1));
-        radiusItem->setTextAlignment(Qt::AlignCenter);
-        trackTable->setItem(row, 1, radiusItem);
-        
-        // Radial Speed
-        QTableWidgetItem* speedItem = new QTableWidgetItem(QString::number(detection.radial_speed, 'f', 2));
-        speedItem->setTextAlignment(Qt::AlignCenter);
-        // Color code based on speed
-        if (detection.radial_speed > 2.0) {
-            speedItem->setBackground(QBrush(QColor(255, 200, 200))); // Light red for approaching
-        } else if (detection.radial_speed < -2.0) {
-            speedItem->setBackground(QBrush(QColor(200, 255, 200))); // Light green for receding
-        } else {
-            speedItem->setBackground(QBrush(QColor(255, 255, 200))); // Light yellow for stationary
-        }
-        trackTable->setItem(row, 2, speedItem);
-        
-        // Azimuth
-        QTableWidgetItem* azimuthItem = new QTableWidgetItem(QString::number(detection.azimuth, 'f', 1));
-        azimuthItem->setTextAlignment(Qt::AlignCenter);
-        trackTable->setItem(row, 3, azimuthItem);
-        
-        row++;
-    }
-    
-    // Auto-resize columns to content
-    trackTable->resizeColumnsToContents();
-}
-
 void MainWindow::onZoomChanged(double zoomLevel)
 {
     zoomLevelLabel->setText(QString("Zoom: %1x").arg(zoomLevel, 0, 'f', 1));
@@ -748,6 +1010,13 @@ void MainWindow::loadSettings()
     config.filter50Hz = settings.value("config/filter50Hz", false).toBool();
     config.filter100Hz = settings.value("config/filter100Hz", false).toBool();
     config.filter150Hz = settings.value("config/filter150Hz", false).toBool();
+    config.smoothTracks = settings.value("config/smoothTracks", false).toBool();
+    config.associateTargets = settings.value("config/associateTargets", false).toBool();
+    config.renderRateHz = settings.value("config/renderRateHz", 60).toInt();
+    config.syncToDisplay = settings.value("config/syncToDisplay", true).toBool();
+    config.threadedRendering = settings.value("config/threadedRendering", false).toBool();
+    config.detectionDisplayMode = settings.value("config/detectionDisplayMode", CustomChart::TrackDisplay).toInt();
+    config.persistenceMs = settings.value("config/persistenceMs", PersistenceMap::DEFAULT_PERSISTENCE_MS).toInt();
     
     applySettings();
 }
@@ -765,6 +1034,13 @@ void MainWindow::saveSettings()
     settings.setValue("config/filter50Hz", config.filter50Hz);
     settings.setValue("config/filter100Hz", config.filter100Hz);
     settings.setValue("config/filter150Hz", config.filter150Hz);
+    settings.setValue("config/smoothTracks", config.smoothTracks);
+    settings.setValue("config/associateTargets", config.associateTargets);
+    settings.setValue("config/renderRateHz", config.renderRateHz);
+    settings.setValue("config/syncToDisplay", config.syncToDisplay);
+    settings.setValue("config/threadedRendering", config.threadedRendering);
+    settings.setValue("config/detectionDisplayMode", config.detectionDisplayMode);
+    settings.setValue("config/persistenceMs", config.persistenceMs);
 }
 
 void MainWindow::applySettings()
@@ -775,6 +1051,30 @@ void MainWindow::applySettings()
     if (filter50Hz) filter50Hz->setChecked(config.filter50Hz);
     if (filter100Hz) filter100Hz->setChecked(config.filter100Hz);
     if (filter150Hz) filter150Hz->setChecked(config.filter150Hz);
+    if (smoothTracksAction) smoothTracksAction->setChecked(config.smoothTracks);
+    if (associateTargetsAction) associateTargetsAction->setChecked(config.associateTargets);
+    if (syncToDisplayAction) syncToDisplayAction->setChecked(config.syncToDisplay);
+    if (threadedRenderingAction) threadedRenderingAction->setChecked(config.threadedRendering);
+    if (displayModeCombo) {
+        int index = displayModeCombo->findData(config.detectionDisplayMode);
+        displayModeCombo->setCurrentIndex(index >= 0 ? index : 0);
+    }
+    if (persistenceCombo) {
+        int index = persistenceCombo->findData(config.persistenceMs);
+        if (index >= 0) {
+            persistenceCombo->setCurrentIndex(index);
+        } else if (detectionChart) {
+            // Hand-edited settings: keep the value even without a matching entry
+            detectionChart->setPersistence(config.persistenceMs);
+        }
+    }
+    if (renderRateGroup) {
+        for (QAction* action : renderRateGroup->actions()) {
+            action->setChecked(action->data().toInt() == config.renderRateHz);
+        }
+    }
+    renderScheduler->setSyncToDisplay(config.syncToDisplay);
+    renderScheduler->setTargetRate(config.renderRateHz);
 }
 
 void MainWindow::updateChartsWithDetections()
@@ -796,33 +1096,13 @@ void MainWindow::onTrackTableSelectionChanged()
 {
     if (!trackTable) return;
     
-    QList<QTableWidgetItem*> selectedItems = trackTable->selectedItems();
-    if (selectedItems.isEmpty()) return;
-    
-    // Get the selected row
-    int row = selectedItems.first()->row();
-    
-    // Get the track ID from the selected row
-    QTableWidgetItem* idItem = trackTable->item(row, 0);
-    if (!idItem) return;
-    
-    uint32_t selectedTrackId = idItem->text().toUInt();
-    
-    // Find the corresponding detection and highlight it
-    QMutexLocker locker(&recentDetectionsMutex);
-    for (const auto& detection : recentDetections) {
-        if (detection.target_id == selectedTrackId) {
-            // Create a TargetDetection from DetectionData for highlighting
-            TargetDetection target;
-            target.target_id = detection.target_id;
-            target.radius = detection.radius;
-            target.radial_speed = detection.radial_speed;
-            target.azimuth = detection.azimuth;
-            target.amplitude = detection.amplitude;
-            target.timestamp = detection.timestamp;
-            
-            highlightTargetInChart(target);
-            break;
-        }
-    }
+    QModelIndexList selectedRows = trackTable->selectionModel()->selectedRows();
+    if (selectedRows.isEmpty()) return;
+    
+    // Map the selected row back to the track it shows
+    QModelIndex sourceIndex = trackProxyModel->mapToSource(selectedRows.first());
+    DetectionData detection;
+    if (!trackModel->trackAt(sourceIndex.row(), detection)) return;
+    
+    highlightTargetInChart(detection.toTargetDetection());
 }
@@ -0,0 +1,209 @@
+#include "markeratlas.h"
+#include <QRadialGradient>
+#include <QStaticText>
+#include <QFont>
+#include <QFontMetrics>
+
+namespace {
+
+const int SIZE_BUCKETS = MarkerAtlas::MAX_MARKER_SIZE - MarkerAtlas::MIN_MARKER_SIZE + 1;
+
+QFont labelFont()
+{
+    return QFont("Arial", 9, QFont::Bold);
+}
+
+} // namespace
+
+MarkerAtlas::MarkerAtlas(Backing backing)
+    : backing(backing)
+    , atlasDevicePixelRatio(0.0)
+    // The glow extends a full marker size around the center, the shadow two
+    // pixels further; one extra pixel keeps the outline pen off the cell edge
+    , cellSize(2 * MAX_MARKER_SIZE + 6)
+{
+}
+
+void MarkerAtlas::prepare(qreal devicePixelRatio)
+{
+    if (devicePixelRatio == atlasDevicePixelRatio && !atlasImage.isNull()) {
+        return;
+    }
+    atlasDevicePixelRatio = devicePixelRatio;
+    labelCache.clear();
+    buildAtlas();
+}
+
+MarkerAtlas::SpeedClass MarkerAtlas::speedClassFor(double speed)
+{
+    if (speed > 2.0) {
+        return Approaching;
+    } else if (speed < -2.0) {
+        return Receding;
+    }
+    return Stationary;
+}
+
+QColor MarkerAtlas::colorFor(SpeedClass speedClass)
+{
+    switch (speedClass) {
+    case Approaching: return QColor(255, 0, 0);     // Red for approaching
+    case Receding:    return QColor(0, 255, 0);     // Green for receding
+    default:          return QColor(255, 255, 0);   // Yellow for stationary
+    }
+}
+
+int MarkerAtlas::markerSizeFor(double amplitude)
+{
+    // Size based on amplitude, with minimum size for visibility
+    return qMax(MIN_MARKER_SIZE, qMin(MAX_MARKER_SIZE, static_cast<int>(amplitude / 5.0 + MIN_MARKER_SIZE)));
+}
+
+void MarkerAtlas::buildAtlas()
+{
+    atlasImage = QImage(QSize(SIZE_BUCKETS * cellSize, SpeedClassCount * cellSize) * atlasDevicePixelRatio,
+                        QImage::Format_ARGB32_Premultiplied);
+    atlasImage.setDevicePixelRatio(atlasDevicePixelRatio);
+    atlasImage.fill(Qt::transparent);
+
+    QPainter painter(&atlasImage);
+    painter.setRenderHint(QPainter::Antialiasing);
+    for (int speedClass = 0; speedClass < SpeedClassCount; ++speedClass) {
+        QColor color = colorFor(static_cast<SpeedClass>(speedClass));
+        for (int bucket = 0; bucket < SIZE_BUCKETS; ++bucket) {
+            QPointF center(bucket * cellSize + cellSize / 2, speedClass * cellSize + cellSize / 2);
+            renderMarker(painter, center, color, MIN_MARKER_SIZE + bucket);
+        }
+    }
+    painter.end();
+
+    if (backing == PixmapBacking) {
+        atlas = QPixmap::fromImage(atlasImage);
+    }
+}
+
+void MarkerAtlas::renderMarker(QPainter& painter, const QPointF& center, const QColor& color, int size) const
+{
+    qreal x = center.x();
+    qreal y = center.y();
+
+    // Draw shadow first
+    QColor shadowColor(0, 0, 0, 80);
+    painter.setPen(QPen(shadowColor, 1));
+    painter.setBrush(QBrush(shadowColor));
+    painter.drawEllipse(QRectF(x - size/2 + 2, y - size/2 + 2, size, size));
+
+    // Draw outer glow
+    QRadialGradient glowGradient(center, size);
+    glowGradient.setColorAt(0, QColor(color.red(), color.green(), color.blue(), 180));
+    glowGradient.setColorAt(0.7, QColor(color.red(), color.green(), color.blue(), 100));
+    glowGradient.setColorAt(1, QColor(color.red(), color.green(), color.blue(), 0));
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(QBrush(glowGradient));
+    painter.drawEllipse(QRectF(x - size, y - size, size * 2, size * 2));
+
+    // Draw main detection marker with gradient
+    QRadialGradient markerGradient(QPointF(x - size/4, y - size/4), size/2);
+    markerGradient.setColorAt(0, color.lighter(150));
+    markerGradient.setColorAt(1, color.darker(120));
+    painter.setPen(QPen(color.darker(140), 2));
+    painter.setBrush(QBrush(markerGradient));
+    painter.drawEllipse(QRectF(x - size/2, y - size/2, size, size));
+
+    // Draw inner highlight
+    QColor highlightColor = color.lighter(200);
+    highlightColor.setAlpha(120);
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(QBrush(highlightColor));
+    painter.drawEllipse(QRectF(x - size/4, y - size/4, size/2, size/2));
+}
+
+const MarkerAtlas::Label& MarkerAtlas::labelFor(uint32_t targetId)
+{
+    auto it = labelCache.constFind(targetId);
+    if (it != labelCache.constEnd()) {
+        return it.value();
+    }
+
+    if (labelCache.size() >= MAX_CACHED_LABELS) {
+        labelCache.clear();
+    }
+
+    QFont font = labelFont();
+    QFontMetrics fm(font);
+    QStaticText text(QString::number(targetId));
+    text.prepare(QTransform(), font);
+    QRect textRect = fm.boundingRect(text.text());
+
+    // Text background, rounded like the other chart labels
+    QSize labelSize(textRect.width() + 4, textRect.height() + 2);
+    Label label;
+    label.image = QImage(labelSize * atlasDevicePixelRatio, QImage::Format_ARGB32_Premultiplied);
+    label.image.setDevicePixelRatio(atlasDevicePixelRatio);
+    label.image.fill(Qt::transparent);
+
+    QPainter painter(&label.image);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(QBrush(QColor(255, 255, 255, 200)));
+    painter.drawRoundedRect(QRect(QPoint(0, 0), labelSize), 3, 3);
+
+    // drawStaticText() places the top-left corner of the text, one pixel into the box
+    painter.setFont(font);
+    painter.setPen(QColor(30, 41, 59));  // Dark blue text
+    painter.drawStaticText(2, 1, text);
+    painter.end();
+
+    if (backing == PixmapBacking) {
+        label.pixmap = QPixmap::fromImage(label.image);
+    }
+
+    return labelCache.insert(targetId, label).value();
+}
+
+void MarkerAtlas::addMarker(const QPointF& center, SpeedClass speedClass, int size)
+{
+    int bucket = qBound(0, size - MIN_MARKER_SIZE, SIZE_BUCKETS - 1);
+
+    // Fragment source rects are in atlas device pixels, so scale back down
+    qreal scale = 1.0 / atlasDevicePixelRatio;
+    qreal cellPixels = cellSize * atlasDevicePixelRatio;
+    markerFragments.append(QPainter::PixmapFragment::create(
+        center, QRectF(bucket * cellPixels, speedClass * cellPixels, cellPixels, cellPixels), scale, scale));
+}
+
+void MarkerAtlas::addLabel(const QPointF& markerCenter, int markerSize, uint32_t targetId)
+{
+    QueuedLabel label;
+    label.topLeft = QPointF(markerCenter.x() + markerSize/2 + 4, markerCenter.y() - markerSize/2 - 4);
+    label.targetId = targetId;
+    queuedLabels.append(label);
+}
+
+void MarkerAtlas::flush(QPainter& painter)
+{
+    if (backing == PixmapBacking) {
+        if (!markerFragments.isEmpty()) {
+            painter.drawPixmapFragments(markerFragments.constData(), markerFragments.size(), atlas);
+        }
+    } else {
+        // Fragments carry the cell center and its source rect in atlas device pixels
+        for (const auto& fragment : markerFragments) {
+            QRectF target(fragment.x - cellSize / 2.0, fragment.y - cellSize / 2.0, cellSize, cellSize);
+            QRectF source(fragment.sourceLeft, fragment.sourceTop, fragment.width, fragment.height);
+            painter.drawImage(target, atlasImage, source);
+        }
+    }
+    markerFragments.clear();
+
+    // Labels go on top of all markers so neighbouring glows never cover an ID
+    for (const auto& label : queuedLabels) {
+        const Label& cached = labelFor(label.targetId);
+        if (backing == PixmapBacking) {
+            painter.drawPixmap(label.topLeft, cached.pixmap);
+        } else {
+            painter.drawImage(label.topLeft, cached.image);
+        }
+    }
+    queuedLabels.clear();
+}
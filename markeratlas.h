@@ -0,0 +1,84 @@
+#ifndef MARKERATLAS_H
+#define MARKERATLAS_H
+
+#include <QPainter>
+#include <QPixmap>
+#include <QImage>
+#include <QHash>
+#include <QVector>
+#include <QColor>
+#include <cstdint>
+
+// Pre-rendered detection glyphs.
+//
+// Every marker variant (speed class color x amplitude size bucket) is drawn
+// once, with its shadow, glow, gradient body and highlight, into a single
+// atlas pixmap. Target ID labels are rendered once per ID into small
+// pixmaps. A frame full of detections then costs one drawPixmapFragments()
+// call for the markers plus one drawPixmap() per label.
+//
+// QPixmap is only safe on the GUI thread, so an atlas that draws on a worker
+// thread uses ImageBacking: the same sprites kept as QImages, drawn with one
+// drawImage() per marker.
+class MarkerAtlas
+{
+public:
+    enum Backing {
+        PixmapBacking,
+        ImageBacking
+    };
+
+    enum SpeedClass {
+        Approaching,
+        Receding,
+        Stationary,
+        SpeedClassCount
+    };
+
+    static constexpr int MIN_MARKER_SIZE = 12;
+    static constexpr int MAX_MARKER_SIZE = 24;
+
+    explicit MarkerAtlas(Backing backing = PixmapBacking);
+
+    // Rebuilds the sprites if the device pixel ratio changed
+    void prepare(qreal devicePixelRatio);
+
+    static SpeedClass speedClassFor(double speed);
+    static QColor colorFor(SpeedClass speedClass);
+    static int markerSizeFor(double amplitude);
+
+    // Batched drawing: queue markers and labels, then flush them in two passes
+    void addMarker(const QPointF& center, SpeedClass speedClass, int size);
+    void addLabel(const QPointF& markerCenter, int markerSize, uint32_t targetId);
+    void flush(QPainter& painter);
+
+private:
+    struct QueuedLabel {
+        QPointF topLeft;
+        uint32_t targetId;
+    };
+
+    struct Label {
+        QImage image;
+        QPixmap pixmap;   // PixmapBacking only
+    };
+
+    Backing backing;
+    QImage atlasImage;
+    QPixmap atlas;    // PixmapBacking only
+    qreal atlasDevicePixelRatio;
+    int cellSize;   // logical pixels per atlas cell
+
+    QHash<uint32_t, Label> labelCache;
+    QVector<QPainter::PixmapFragment> markerFragments;
+    QVector<QueuedLabel> queuedLabels;
+
+    void buildAtlas();
+    void renderMarker(QPainter& painter, const QPointF& center, const QColor& color, int size) const;
+    const Label& labelFor(uint32_t targetId);
+
+    // Bounded so IDs that come and go cannot grow the cache forever
+    static constexpr int MAX_CACHED_LABELS = 4096;
+};
+
+#endif // MARKERATLAS_H
@@ -0,0 +1,202 @@
+#include "persistencemap.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+struct ColorStop {
+    double position;
+    int red, green, blue, alpha;
+};
+
+// Transparent for no traffic, through blue and cyan to yellow and red
+const ColorStop COLORMAP_STOPS[] = {
+    { 0.00,   0,   0, 160,   0 },
+    { 0.25,   0,  90, 255, 110 },
+    { 0.50,   0, 220, 220, 160 },
+    { 0.75, 255, 220,   0, 200 },
+    { 1.00, 255,  40,   0, 230 },
+};
+
+} // namespace
+
+// PersistenceMap Implementation
+PersistenceMap::PersistenceMap()
+    : bins(BIN_COUNT, 0.0f)
+    , epochMs(0)
+    , latestMs(0)
+    , persistenceMs(DEFAULT_PERSISTENCE_MS)
+    , tauMs(DEFAULT_PERSISTENCE_MS / 3.0)
+    , empty(true)
+    , lookupRadius(0)
+    , binColors(BIN_COUNT + 1, 0)
+    , coloredAtMs(0)
+    , dirty(true)
+{
+    // Premultiplied, so the pixel loop is a plain copy
+    const int stopCount = sizeof(COLORMAP_STOPS) / sizeof(COLORMAP_STOPS[0]);
+    for (int i = 0; i < 256; ++i) {
+        double position = i / 255.0;
+        int stop = 1;
+        while (stop < stopCount - 1 && position > COLORMAP_STOPS[stop].position) {
+            ++stop;
+        }
+        const ColorStop& from = COLORMAP_STOPS[stop - 1];
+        const ColorStop& to = COLORMAP_STOPS[stop];
+        double t = (position - from.position) / (to.position - from.position);
+        auto mix = [t](int a, int b) { return static_cast<int>(std::lround(a + (b - a) * t)); };
+        colormap[i] = qPremultiply(qRgba(mix(from.red, to.red), mix(from.green, to.green),
+                                         mix(from.blue, to.blue), mix(from.alpha, to.alpha)));
+    }
+    colormap[0] = 0;
+}
+
+void PersistenceMap::setPersistence(int newPersistenceMs)
+{
+    newPersistenceMs = std::max(newPersistenceMs, 1000);
+    if (newPersistenceMs == persistenceMs) {
+        return;
+    }
+
+    // Bins are scaled for the old time constant; settle them first
+    if (!empty) {
+        rebase(latestMs);
+    }
+    persistenceMs = newPersistenceMs;
+    tauMs = persistenceMs / 3.0;   // e^-3 is about 5%
+    dirty = true;
+}
+
+void PersistenceMap::add(double radius, double azimuth, qint64 timeMs)
+{
+    if (!(radius >= 0.0) || azimuth < -90.0 || azimuth > 90.0) {
+        return;
+    }
+
+    if (empty) {
+        epochMs = timeMs;
+        latestMs = timeMs;
+        empty = false;
+    } else if (timeMs - epochMs > REBASE_AFTER_TAUS * tauMs) {
+        rebase(timeMs);
+    }
+
+    int rangeBin = std::min(static_cast<int>(radius / MAX_RANGE_M * RANGE_BINS), RANGE_BINS - 1);
+    int azimuthBin = std::min(static_cast<int>((azimuth + 90.0) / 180.0 * AZIMUTH_BINS), AZIMUTH_BINS - 1);
+    bins[rangeBin * AZIMUTH_BINS + azimuthBin] += static_cast<float>(std::exp((timeMs - epochMs) / tauMs));
+    latestMs = std::max(latestMs, timeMs);
+    dirty = true;
+}
+
+void PersistenceMap::clear()
+{
+    std::fill(bins.begin(), bins.end(), 0.0f);
+    epochMs = 0;
+    latestMs = 0;
+    empty = true;
+    dirty = true;
+}
+
+void PersistenceMap::rebase(qint64 timeMs)
+{
+    float factor = static_cast<float>(std::exp(-(timeMs - epochMs) / tauMs));
+    for (float& value : bins) {
+        value *= factor;
+    }
+    epochMs = timeMs;
+}
+
+int PersistenceMap::refreshInterval() const
+{
+    // Each refresh dims the picture by well under 2%
+    return std::max(100, persistenceMs / 200);
+}
+
+void PersistenceMap::draw(QPainter& painter, const QPoint& center, int maxRadius, qint64 nowMs)
+{
+    if (maxRadius <= 0) {
+        return;
+    }
+    if (center != lookupCenter || maxRadius != lookupRadius) {
+        rebuildLookup(center, maxRadius);
+        dirty = true;
+    }
+    if (empty) {
+        dirty = false;
+        return;
+    }
+
+    if (dirty || nowMs - coloredAtMs >= refreshInterval()) {
+        recolor(nowMs);
+        if (empty) {
+            return;
+        }
+    }
+    painter.drawImage(QPoint(lookupCenter.x(), lookupCenter.y() - lookupRadius), image);
+}
+
+void PersistenceMap::rebuildLookup(const QPoint& center, int maxRadius)
+{
+    lookupCenter = center;
+    lookupRadius = maxRadius;
+
+    // The plot is the right half disc: x from the center outwards, y one
+    // radius above and below it
+    int width = maxRadius + 1;
+    int height = 2 * maxRadius + 1;
+    pixelBins.resize(static_cast<size_t>(width) * height);
+    image = QImage(width, height, QImage::Format_ARGB32_Premultiplied);
+
+    int* pixelBin = pixelBins.data();
+    for (int y = 0; y < height; ++y) {
+        double dy = maxRadius - y - 0.5;
+        for (int x = 0; x < width; ++x) {
+            double dx = x + 0.5;
+            double distance = std::sqrt(dx * dx + dy * dy);
+            if (distance > maxRadius) {
+                *pixelBin++ = BIN_COUNT;
+                continue;
+            }
+            double azimuth = std::atan2(dy, dx) * 180.0 / M_PI;
+            int rangeBin = std::min(static_cast<int>(distance / maxRadius * RANGE_BINS), RANGE_BINS - 1);
+            int azimuthBin = std::min(static_cast<int>((azimuth + 90.0) / 180.0 * AZIMUTH_BINS), AZIMUTH_BINS - 1);
+            *pixelBin++ = rangeBin * AZIMUTH_BINS + std::max(azimuthBin, 0);
+        }
+    }
+}
+
+void PersistenceMap::recolor(qint64 nowMs)
+{
+    coloredAtMs = nowMs;
+    dirty = false;
+
+    // One common decay factor for every bin; 1 - exp(-w) keeps a single
+    // detection faint and saturates smoothly on busy cells
+    double scale = std::exp(-(nowMs - epochMs) / tauMs) / SATURATION_WEIGHT;
+    bool visible = false;
+    for (int i = 0; i < BIN_COUNT; ++i) {
+        float value = bins[i];
+        if (value <= 0.0f) {
+            binColors[i] = 0;
+            continue;
+        }
+        int index = static_cast<int>(255.0 * (1.0 - std::exp(-value * scale)));
+        binColors[i] = colormap[index];
+        visible = visible || index > 0;
+    }
+
+    // Everything has faded out
+    if (!visible) {
+        clear();
+        dirty = false;
+        return;
+    }
+
+    const int* pixelBin = pixelBins.data();
+    for (int y = 0; y < image.height(); ++y) {
+        QRgb* line = reinterpret_cast<QRgb*>(image.scanLine(y));
+        for (int x = 0; x < image.width(); ++x) {
+            line[x] = binColors[*pixelBin++];
+        }
+    }
+}
@@ -0,0 +1,80 @@
+#ifndef PERSISTENCEMAP_H
+#define PERSISTENCEMAP_H
+
+#include <QImage>
+#include <QPainter>
+#include <QPoint>
+#include <QRgb>
+#include <array>
+#include <vector>
+
+// Afterglow of the detection chart: where traffic has been over the last
+// minutes, as a heat map instead of one marker per old detection.
+//
+// Every detection adds to one polar bin of a float accumulation buffer
+// that decays exponentially. Decay is lazy: bins hold weight * exp(t / tau)
+// relative to an epoch, so adding a detection touches a single bin and a
+// render scales all bins by one common factor. The epoch is moved forward,
+// rescaling every bin once, before that factor grows large. Rendering
+// colours each bin through a 256-entry colormap, then fills the pixels of
+// the plot through a pixel-to-bin lookup table that is only rebuilt when
+// the plot geometry changes. Cost is O(new detections) to add and O(bins +
+// plot pixels) to render, however much history is shown.
+class PersistenceMap
+{
+public:
+    static constexpr int RANGE_BINS = 50;        // 2 m over the 0-100 m plot
+    static constexpr int AZIMUTH_BINS = 90;      // 2 degrees over -90 to +90
+    static constexpr double MAX_RANGE_M = 100.0;
+    static constexpr int DEFAULT_PERSISTENCE_MS = 60000;
+
+    PersistenceMap();
+
+    // A detection fades to 5% of its weight after persistenceMs
+    void setPersistence(int persistenceMs);
+    int getPersistence() const { return persistenceMs; }
+
+    // Detections beyond the plot range pile up on its edge, like the markers
+    void add(double radius, double azimuth, qint64 timeMs);
+    void clear();
+    bool isEmpty() const { return empty; }
+
+    // Draws the afterglow as of nowMs; center and maxRadius as for
+    // DetectionRenderer::polarToPoint. The image is only recoloured when
+    // detections were added, the geometry changed or refreshInterval()
+    // has passed since the last recolour.
+    void draw(QPainter& painter, const QPoint& center, int maxRadius, qint64 nowMs);
+
+    // How often the fading picture needs to be redrawn
+    int refreshInterval() const;
+
+private:
+    static constexpr int BIN_COUNT = RANGE_BINS * AZIMUTH_BINS;
+    static constexpr double SATURATION_WEIGHT = 8.0;   // decayed weight that nears the hottest colour
+    static constexpr double REBASE_AFTER_TAUS = 16.0;  // keeps the float growth factor below e^16
+
+    std::vector<float> bins;   // range-major, weight * exp((t - epochMs) / tau)
+    qint64 epochMs;
+    qint64 latestMs;
+    int persistenceMs;
+    double tauMs;
+    bool empty;
+
+    // Pixel-to-bin lookup over the bounding box of the half disc; pixels
+    // outside the plot map to BIN_COUNT, whose colour is transparent
+    QPoint lookupCenter;
+    int lookupRadius;
+    std::vector<int> pixelBins;
+
+    std::vector<QRgb> binColors;   // BIN_COUNT + 1 entries, reused
+    std::array<QRgb, 256> colormap;
+    QImage image;
+    qint64 coloredAtMs;
+    bool dirty;
+
+    void rebase(qint64 timeMs);
+    void rebuildLookup(const QPoint& center, int maxRadius);
+    void recolor(qint64 nowMs);
+};
+
+#endif // PERSISTENCEMAP_H
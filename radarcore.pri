@@ -0,0 +1,39 @@
+# Headless radar core: ingest, parsing, detection storage, DSP settings,
+# raw UDP capture/replay, latency statistics, logging, target association,
+# track storage and smoothing.
+# Depends only on QtCore/QtNetwork. Included by the GUI, the recorder and
+# radarcore.pro (static library build).
+
+QT += core network
+
+INCLUDEPATH += $$PWD
+DEPENDPATH += $$PWD
+
+HEADERS += \
+    $$PWD/structures.h \
+    $$PWD/crc16.h \
+    $$PWD/udphandler.h \
+    $$PWD/udpreceiver.h \
+    $$PWD/detectionparser.h \
+    $$PWD/spscringbuffer.h \
+    $$PWD/capturefile.h \
+    $$PWD/capturerecorder.h \
+    $$PWD/capturereplay.h \
+    $$PWD/latencystats.h \
+    $$PWD/radarlog.h \
+    $$PWD/trackassociator.h \
+    $$PWD/trackfilter.h \
+    $$PWD/trackstore.h
+
+SOURCES += \
+    $$PWD/udphandler.cpp \
+    $$PWD/udpreceiver.cpp \
+    $$PWD/detectionparser.cpp \
+    $$PWD/capturefile.cpp \
+    $$PWD/capturerecorder.cpp \
+    $$PWD/capturereplay.cpp \
+    $$PWD/latencystats.cpp \
+    $$PWD/radarlog.cpp \
+    $$PWD/trackassociator.cpp \
+    $$PWD/trackfilter.cpp \
+    $$PWD/trackstore.cpp
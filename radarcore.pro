@@ -0,0 +1,7 @@
+# Static library with the headless radar core (see radarcore.pri)
+TEMPLATE = lib
+TARGET = radarcore
+CONFIG += staticlib c++17
+QT = core network
+
+include(radarcore.pri)
@@ -0,0 +1,316 @@
+#include "radarlog.h"
+#include "spscringbuffer.h"
+#include <QDateTime>
+#include <QFile>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <QWaitCondition>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+namespace {
+
+// One less than a power of two: the ring keeps a spare slot, so this fills 4096
+const size_t RING_RECORDS = 4095;
+const int FLUSH_INTERVAL_MS = 20;
+
+const char* levelName(RadarLog::Level level)
+{
+    switch (level) {
+    case RadarLog::Trace:   return "TRACE";
+    case RadarLog::Debug:   return "DEBUG";
+    case RadarLog::Info:    return "INFO";
+    case RadarLog::Warning: return "WARN";
+    case RadarLog::Error:   return "ERROR";
+    }
+    return "?";
+}
+
+// Records of one producer thread. The ring is shared with the flusher, so
+// it stays alive until the flusher has drained it after the thread exited.
+struct ThreadRing {
+    SpscRingBuffer<RadarLog::Record> records;
+    std::atomic<quint64> dropped;
+    std::atomic<bool> retired;
+    quint64 reportedDropped;   // flusher side
+    QByteArray name;
+
+    ThreadRing() : records(RING_RECORDS), dropped(0), retired(false), reportedDropped(0) {}
+};
+
+struct ThreadRingHandle {
+    std::shared_ptr<ThreadRing> ring;
+
+    ~ThreadRingHandle()
+    {
+        if (ring) {
+            ring->retired.store(true, std::memory_order_release);
+        }
+    }
+};
+
+thread_local ThreadRingHandle threadRing;
+
+class Logger
+{
+public:
+    static Logger& instance()
+    {
+        // Never destroyed: threads may still log while static destructors run.
+        // The flusher is stopped and drained from an atexit handler instead.
+        static Logger* logger = []() {
+            Logger* created = new Logger();
+            std::atexit([]() { instance().shutdown(); });
+            return created;
+        }();
+        return *logger;
+    }
+
+    void submit(const RadarLog::Record& record)
+    {
+        ThreadRing* ring = ringForThisThread();
+        if (stopped.load(std::memory_order_acquire)) {
+            // After shutdown there is no flusher; write synchronously
+            QMutexLocker locker(&drainMutex);
+            writeRecord(record, ring->name);
+            std::fflush(output);
+            return;
+        }
+
+        if (!ring->records.tryPush(record)) {
+            ring->dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void drain()
+    {
+        QMutexLocker locker(&drainMutex);
+
+        std::vector<std::shared_ptr<ThreadRing>> snapshot;
+        {
+            QMutexLocker registryLocker(&registryMutex);
+            snapshot = rings;
+        }
+
+        // Collect from every ring, then merge by time so lines from different
+        // threads come out in the order they were logged
+        pending.clear();
+        for (const auto& ring : snapshot) {
+            RadarLog::Record record;
+            while (ring->records.tryPop(record)) {
+                pending.push_back({ record, ring.get() });
+            }
+
+            quint64 dropped = ring->dropped.load(std::memory_order_relaxed);
+            if (dropped != ring->reportedDropped) {
+                std::fprintf(output, "%s [%s] %llu log records dropped, ring full\n", levelName(RadarLog::Warning),
+                             ring->name.constData(), static_cast<unsigned long long>(dropped - ring->reportedDropped));
+                totalDropped.fetch_add(dropped - ring->reportedDropped, std::memory_order_relaxed);
+                ring->reportedDropped = dropped;
+            }
+        }
+        std::stable_sort(pending.begin(), pending.end(), [](const PendingRecord& a, const PendingRecord& b) {
+            return a.record.timeUs < b.record.timeUs;
+        });
+
+        for (const auto& entry : pending) {
+            writeRecord(entry.record, entry.ring->name);
+        }
+        if (!pending.empty()) {
+            std::fflush(output);
+        }
+
+        // Forget rings of threads that have exited once they are empty
+        QMutexLocker registryLocker(&registryMutex);
+        rings.erase(std::remove_if(rings.begin(), rings.end(), [](const std::shared_ptr<ThreadRing>& ring) {
+            return ring->retired.load(std::memory_order_acquire) && ring->records.empty();
+        }), rings.end());
+    }
+
+    bool setOutputFile(const QString& path)
+    {
+        QMutexLocker locker(&drainMutex);
+        FILE* file = stderr;
+        if (!path.isEmpty()) {
+            file = std::fopen(QFile::encodeName(path).constData(), "a");
+            if (!file) {
+                return false;
+            }
+        }
+        if (output != stderr) {
+            std::fclose(output);
+        }
+        output = file;
+        return true;
+    }
+
+    quint64 droppedCount() const
+    {
+        return totalDropped.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct PendingRecord {
+        RadarLog::Record record;
+        ThreadRing* ring;
+    };
+
+    QMutex registryMutex;
+    std::vector<std::shared_ptr<ThreadRing>> rings;
+    int nextThreadId;
+
+    // Consumer side; flush() may drain from another thread, so draining is serialised
+    QMutex drainMutex;
+    FILE* output;
+    std::vector<PendingRecord> pending;
+    QByteArray line;
+    std::atomic<quint64> totalDropped;
+
+    QMutex wakeMutex;
+    QWaitCondition wake;
+    bool stopRequested;
+    std::atomic<bool> stopped;
+    std::unique_ptr<QThread> flusher;
+
+    Logger()
+        : nextThreadId(1)
+        , output(stderr)
+        , totalDropped(0)
+        , stopRequested(false)
+        , stopped(false)
+    {
+        pending.reserve(RING_RECORDS);
+        flusher.reset(QThread::create([this]() { flusherLoop(); }));
+        flusher->setObjectName("RadarLog");
+        flusher->start(QThread::LowPriority);
+    }
+
+    ThreadRing* ringForThisThread()
+    {
+        if (!threadRing.ring) {
+            auto ring = std::make_shared<ThreadRing>();
+            QMutexLocker locker(&registryMutex);
+            QThread* thread = QThread::currentThread();
+            QString threadName = thread ? thread->objectName() : QString();
+            ring->name = QByteArray("T") + QByteArray::number(nextThreadId++);
+            if (!threadName.isEmpty()) {
+                ring->name += ' ' + threadName.toUtf8();
+            }
+            rings.push_back(ring);
+            threadRing.ring = std::move(ring);
+        }
+        return threadRing.ring.get();
+    }
+
+    void flusherLoop()
+    {
+        QMutexLocker locker(&wakeMutex);
+        while (!stopRequested) {
+            wake.wait(&wakeMutex, FLUSH_INTERVAL_MS);
+            locker.unlock();
+            drain();
+            locker.relock();
+        }
+    }
+
+    void shutdown()
+    {
+        {
+            QMutexLocker locker(&wakeMutex);
+            stopRequested = true;
+            wake.wakeOne();
+        }
+        flusher->wait();
+        drain();
+        stopped.store(true, std::memory_order_release);
+    }
+
+    void writeRecord(const RadarLog::Record& record, const QByteArray& threadName)
+    {
+        line = QDateTime::fromMSecsSinceEpoch(record.timeUs / 1000).toString("yyyy-MM-dd hh:mm:ss.zzz").toLatin1();
+        char buffer[64];
+        std::snprintf(buffer, sizeof(buffer), "%03lld %-5s [", static_cast<long long>(record.timeUs % 1000),
+                      levelName(record.level));
+        line += buffer;
+        line += threadName;
+        line += "] ";
+
+        // "{}" placeholders take the arguments in order; extra arguments are appended
+        int arg = 0;
+        for (const char* c = record.format; *c; ++c) {
+            if (c[0] == '{' && c[1] == '}' && arg < record.argCount) {
+                appendArg(record, arg++);
+                ++c;
+            } else {
+                line += *c;
+            }
+        }
+        for (; arg < record.argCount; ++arg) {
+            line += ' ';
+            appendArg(record, arg);
+        }
+        line += '\n';
+
+        std::fwrite(line.constData(), 1, static_cast<size_t>(line.size()), output);
+    }
+
+    void appendArg(const RadarLog::Record& record, int index)
+    {
+        const RadarLog::Record::Value& value = record.values[index];
+        char buffer[32];
+        switch (record.types[index]) {
+        case RadarLog::SignedArg:
+            std::snprintf(buffer, sizeof(buffer), "%lld", static_cast<long long>(value.i));
+            line += buffer;
+            break;
+        case RadarLog::UnsignedArg:
+            std::snprintf(buffer, sizeof(buffer), "%llu", static_cast<unsigned long long>(value.u));
+            line += buffer;
+            break;
+        case RadarLog::DoubleArg:
+            std::snprintf(buffer, sizeof(buffer), "%g", value.d);
+            line += buffer;
+            break;
+        case RadarLog::BoolArg:
+            line += value.u ? "true" : "false";
+            break;
+        case RadarLog::TextArg:
+            line.append(record.text + value.text.offset, value.text.length);
+            break;
+        }
+    }
+};
+
+} // namespace
+
+bool RadarLog::setOutputFile(const QString& path)
+{
+    return Logger::instance().setOutputFile(path);
+}
+
+void RadarLog::flush()
+{
+    Logger::instance().drain();
+}
+
+quint64 RadarLog::droppedCount()
+{
+    return Logger::instance().droppedCount();
+}
+
+qint64 RadarLog::Detail::nowUs()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+void RadarLog::Detail::submit(const Record& record)
+{
+    Logger::instance().submit(record);
+}
@@ -0,0 +1,188 @@
+#ifndef RADARLOG_H
+#define RADARLOG_H
+
+#include <QByteArray>
+#include <QString>
+#include <QtGlobal>
+#include <cstring>
+#include <type_traits>
+
+// Asynchronous logging for the ingest path.
+//
+//   RADAR_LOG_DEBUG("Detection {} at {} m", detection.target_id, detection.radius);
+//
+// A log call captures the format string pointer and up to MAX_ARGS raw
+// argument values into a fixed-size record and pushes it into a lock-free
+// ring owned by the calling thread; nothing is formatted and no lock is
+// taken. A background thread drains all rings, formats "{}" placeholders
+// and writes the lines to stderr or a log file. When a thread's ring is
+// full the record is dropped and counted rather than blocking the caller.
+//
+// Levels below RADAR_LOG_LEVEL compile to nothing. The default keeps debug
+// output in debug builds and drops it from release builds; define
+// RADAR_LOG_LEVEL (e.g. -DRADAR_LOG_LEVEL=0) to override.
+//
+// The format must be a string literal. Integers, floating point values,
+// bools, enums, C strings, QByteArray and QString are accepted; string
+// arguments are copied (truncated if needed) into the record.
+
+#define RADAR_LOG_LEVEL_TRACE   0
+#define RADAR_LOG_LEVEL_DEBUG   1
+#define RADAR_LOG_LEVEL_INFO    2
+#define RADAR_LOG_LEVEL_WARNING 3
+#define RADAR_LOG_LEVEL_ERROR   4
+#define RADAR_LOG_LEVEL_OFF     5
+
+#ifndef RADAR_LOG_LEVEL
+#  ifdef QT_NO_DEBUG
+#    define RADAR_LOG_LEVEL RADAR_LOG_LEVEL_INFO
+#  else
+#    define RADAR_LOG_LEVEL RADAR_LOG_LEVEL_DEBUG
+#  endif
+#endif
+
+namespace RadarLog {
+
+enum Level : quint8 {
+    Trace = RADAR_LOG_LEVEL_TRACE,
+    Debug = RADAR_LOG_LEVEL_DEBUG,
+    Info = RADAR_LOG_LEVEL_INFO,
+    Warning = RADAR_LOG_LEVEL_WARNING,
+    Error = RADAR_LOG_LEVEL_ERROR
+};
+
+static constexpr int MAX_ARGS = 8;
+static constexpr int TEXT_BYTES = 96;
+
+enum ArgType : quint8 {
+    SignedArg,
+    UnsignedArg,
+    DoubleArg,
+    BoolArg,
+    TextArg
+};
+
+// One log call, as stored in the per-thread ring. Trivially copyable.
+struct Record {
+    qint64 timeUs;                 // wall clock, microseconds since the epoch
+    const char* format;            // string literal
+    Level level;
+    quint8 argCount;
+    quint8 textUsed;
+    ArgType types[MAX_ARGS];
+    union Value {
+        qint64 i;
+        quint64 u;
+        double d;
+        struct { quint8 offset; quint8 length; } text;
+    } values[MAX_ARGS];
+    char text[TEXT_BYTES];         // copied string arguments
+};
+
+// Sends records to a file instead of stderr. An empty path restores stderr.
+bool setOutputFile(const QString& path);
+
+// Formats and writes everything queued so far before returning
+void flush();
+
+// Records dropped because a thread's ring was full
+quint64 droppedCount();
+
+namespace Detail {
+
+qint64 nowUs();
+void submit(const Record& record);
+
+inline void appendText(Record& record, const char* data, size_t length)
+{
+    size_t space = TEXT_BYTES - record.textUsed;
+    length = qMin(length, space);
+    Record::Value& value = record.values[record.argCount];
+    value.text.offset = record.textUsed;
+    value.text.length = static_cast<quint8>(length);
+    std::memcpy(record.text + record.textUsed, data, length);
+    record.textUsed = static_cast<quint8>(record.textUsed + length);
+    record.types[record.argCount] = TextArg;
+}
+
+template <typename T>
+inline void capture(Record& record, const T& arg)
+{
+    using U = std::decay_t<T>;
+    if constexpr (std::is_same<U, bool>::value) {
+        record.types[record.argCount] = BoolArg;
+        record.values[record.argCount].u = arg ? 1 : 0;
+    } else if constexpr (std::is_enum<U>::value) {
+        record.types[record.argCount] = SignedArg;
+        record.values[record.argCount].i = static_cast<qint64>(arg);
+    } else if constexpr (std::is_integral<U>::value && std::is_signed<U>::value) {
+        record.types[record.argCount] = SignedArg;
+        record.values[record.argCount].i = static_cast<qint64>(arg);
+    } else if constexpr (std::is_integral<U>::value) {
+        record.types[record.argCount] = UnsignedArg;
+        record.values[record.argCount].u = static_cast<quint64>(arg);
+    } else if constexpr (std::is_floating_point<U>::value) {
+        record.types[record.argCount] = DoubleArg;
+        record.values[record.argCount].d = static_cast<double>(arg);
+    } else if constexpr (std::is_same<U, QByteArray>::value) {
+        appendText(record, arg.constData(), static_cast<size_t>(arg.size()));
+    } else if constexpr (std::is_same<U, QString>::value) {
+        QByteArray utf8 = arg.toUtf8();
+        appendText(record, utf8.constData(), static_cast<size_t>(utf8.size()));
+    } else {
+        static_assert(std::is_convertible<U, const char*>::value, "unsupported log argument type");
+        const char* string = arg;
+        appendText(record, string ? string : "(null)", string ? std::strlen(string) : 6);
+    }
+    record.argCount++;
+}
+
+template <typename... Args>
+inline void log(Level level, const char* format, const Args&... args)
+{
+    static_assert(sizeof...(Args) <= MAX_ARGS, "too many log arguments");
+
+    Record record;
+    record.timeUs = nowUs();
+    record.format = format;
+    record.level = level;
+    record.argCount = 0;
+    record.textUsed = 0;
+    (capture(record, args), ...);
+    submit(record);
+}
+
+} // namespace Detail
+} // namespace RadarLog
+
+#if RADAR_LOG_LEVEL <= RADAR_LOG_LEVEL_TRACE
+#  define RADAR_LOG_TRACE(...) ::RadarLog::Detail::log(::RadarLog::Trace, __VA_ARGS__)
+#else
+#  define RADAR_LOG_TRACE(...) do {} while (0)
+#endif
+
+#if RADAR_LOG_LEVEL <= RADAR_LOG_LEVEL_DEBUG
+#  define RADAR_LOG_DEBUG(...) ::RadarLog::Detail::log(::RadarLog::Debug, __VA_ARGS__)
+#else
+#  define RADAR_LOG_DEBUG(...) do {} while (0)
+#endif
+
+#if RADAR_LOG_LEVEL <= RADAR_LOG_LEVEL_INFO
+#  define RADAR_LOG_INFO(...) ::RadarLog::Detail::log(::RadarLog::Info, __VA_ARGS__)
+#else
+#  define RADAR_LOG_INFO(...) do {} while (0)
+#endif
+
+#if RADAR_LOG_LEVEL <= RADAR_LOG_LEVEL_WARNING
+#  define RADAR_LOG_WARNING(...) ::RadarLog::Detail::log(::RadarLog::Warning, __VA_ARGS__)
+#else
+#  define RADAR_LOG_WARNING(...) do {} while (0)
+#endif
+
+#if RADAR_LOG_LEVEL <= RADAR_LOG_LEVEL_ERROR
+#  define RADAR_LOG_ERROR(...) ::RadarLog::Detail::log(::RadarLog::Error, __VA_ARGS__)
+#else
+#  define RADAR_LOG_ERROR(...) do {} while (0)
+#endif
+
+#endif // RADARLOG_H
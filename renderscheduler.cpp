@@ -0,0 +1,204 @@
+#include "renderscheduler.h"
+#include <QGuiApplication>
+#include <QScreen>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const double MIN_RATE_HZ = 1.0;
+const double MAX_RATE_HZ = 480.0;
+const qint64 RATE_WINDOW_NS = 1000000000;   // frame rate is averaged over about a second
+
+} // namespace
+
+// RenderScheduler Implementation
+RenderScheduler::RenderScheduler(QObject* parent)
+    : QObject(parent)
+    , targetRateHz(DEFAULT_TARGET_RATE_HZ)
+    , syncToDisplay(true)
+    , periodNs(0)
+    , nextDeadlineNs(0)
+    , rateWindowStartNs(0)
+    , rateWindowFrames(0)
+    , frameRequested(false)
+    , inFrame(false)
+{
+    frameTimer = new QTimer(this);
+    frameTimer->setSingleShot(true);
+    frameTimer->setTimerType(Qt::PreciseTimer);
+    connect(frameTimer, &QTimer::timeout, this, &RenderScheduler::onFrame);
+
+    clock.start();
+    updatePeriod();
+}
+
+void RenderScheduler::setTargetRate(double hz)
+{
+    targetRateHz = qBound(MIN_RATE_HZ, hz, MAX_RATE_HZ);
+    updatePeriod();
+}
+
+void RenderScheduler::setSyncToDisplay(bool enabled)
+{
+    syncToDisplay = enabled;
+    updatePeriod();
+}
+
+void RenderScheduler::addWidget(QWidget* widget)
+{
+    if (!widget) {
+        return;
+    }
+    for (const auto& target : targets) {
+        if (target.widget == widget) {
+            return;
+        }
+    }
+    targets.push_back(Target{ widget, false });
+}
+
+void RenderScheduler::removeWidget(QWidget* widget)
+{
+    targets.erase(std::remove_if(targets.begin(), targets.end(),
+                                 [widget](const Target& target) { return target.widget == widget; }),
+                  targets.end());
+}
+
+void RenderScheduler::markDirty(QWidget* widget)
+{
+    for (auto& target : targets) {
+        if (target.widget == widget) {
+            target.dirty = true;
+            wake();
+            return;
+        }
+    }
+
+    // Not registered: fall back to Qt's own scheduling
+    if (widget) {
+        widget->update();
+    }
+}
+
+void RenderScheduler::requestFrame()
+{
+    frameRequested = true;
+    wake();
+}
+
+void RenderScheduler::resetStatistics()
+{
+    stats = Statistics();
+    rateWindowFrames = 0;
+}
+
+void RenderScheduler::onFrame()
+{
+    qint64 now = clock.nsecsElapsed();
+    qint64 lateness = now - nextDeadlineNs;
+
+    // Whole periods that went by without a frame were dropped
+    if (lateness >= periodNs) {
+        qint64 missed = lateness / periodNs;
+        stats.droppedFrames += static_cast<quint64>(missed);
+        nextDeadlineNs += missed * periodNs;
+        lateness -= missed * periodNs;
+    }
+    if (lateness > periodNs / 4) {
+        stats.lateFrames++;
+    }
+
+    // Idle time counts, so this is the rate frames actually reach the screen
+    if (rateWindowFrames == 0) {
+        rateWindowStartNs = now;
+    }
+    rateWindowFrames++;
+    if (now - rateWindowStartNs >= RATE_WINDOW_NS) {
+        stats.frameRate = (rateWindowFrames - 1) * 1e9 / (now - rateWindowStartNs);
+        rateWindowFrames = 1;
+        rateWindowStartNs = now;
+    }
+
+    nextDeadlineNs += periodNs;
+    stats.frames++;
+
+    // Handlers may stage data, mark widgets dirty or request another frame
+    inFrame = true;
+    frameRequested = false;
+    emit frameTick(now);
+
+    for (auto& target : targets) {
+        if (!target.dirty || !target.widget) continue;
+        target.dirty = false;
+        if (target.widget->isVisible()) {
+            target.widget->update();
+        }
+    }
+
+    targets.erase(std::remove_if(targets.begin(), targets.end(),
+                                 [](const Target& target) { return target.widget.isNull(); }),
+                  targets.end());
+    inFrame = false;
+
+    if (hasPendingWork()) {
+        scheduleFrame();
+    }
+}
+
+void RenderScheduler::updatePeriod()
+{
+    double period = 1.0 / targetRateHz;
+
+    // A whole number of display refreshes keeps frames in step with the display
+    if (syncToDisplay) {
+        QScreen* screen = QGuiApplication::primaryScreen();
+        if (screen && screen->refreshRate() > 1.0) {
+            double refreshRate = screen->refreshRate();
+            double refreshes = qMax(1.0, std::round(refreshRate / targetRateHz));
+            period = refreshes / refreshRate;
+        }
+    }
+
+    periodNs = static_cast<qint64>(period * 1e9);
+
+    if (frameTimer->isActive()) {
+        frameTimer->stop();
+        nextDeadlineNs = clock.nsecsElapsed();
+        scheduleFrame();
+    }
+}
+
+void RenderScheduler::wake()
+{
+    if (frameTimer->isActive() || inFrame) {
+        return;
+    }
+
+    // Coming out of idle: keep to the frame grid if the next frame is not
+    // due yet, otherwise start now. Idle time is neither late nor dropped.
+    qint64 now = clock.nsecsElapsed();
+    if (nextDeadlineNs < now) {
+        nextDeadlineNs = now;
+    }
+    scheduleFrame();
+}
+
+void RenderScheduler::scheduleFrame()
+{
+    qint64 waitNs = qMax<qint64>(0, nextDeadlineNs - clock.nsecsElapsed());
+    frameTimer->start(static_cast<int>(waitNs / 1000000));
+}
+
+bool RenderScheduler::hasPendingWork() const
+{
+    if (frameRequested) {
+        return true;
+    }
+    for (const auto& target : targets) {
+        if (target.dirty && target.widget) {
+            return true;
+        }
+    }
+    return false;
+}
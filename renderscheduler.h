@@ -0,0 +1,92 @@
+#ifndef RENDERSCHEDULER_H
+#define RENDERSCHEDULER_H
+
+#include <QObject>
+#include <QPointer>
+#include <QWidget>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <vector>
+
+// Paces repaints of every registered widget to one frame rate.
+//
+// Data arriving at any rate only marks a widget dirty; once per frame the
+// scheduler emits frameTick(), so staged models can fold in their updates,
+// then calls update() on each dirty, visible widget. Qt coalesces those
+// into one backing store flush per window, so ingest rate and repaint rate
+// are fully decoupled. With display sync on, the frame period is a whole
+// number of display refreshes of the primary screen, as close to the
+// target rate as possible. The timer stops while nothing is dirty.
+//
+// A frame that starts more than a quarter period after its deadline is
+// late; whole periods that pass without a frame while work was waiting are
+// dropped. Both usually mean painting or the event loop is overloaded.
+// GUI thread only.
+class RenderScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Statistics {
+        quint64 frames = 0;
+        quint64 droppedFrames = 0;
+        quint64 lateFrames = 0;
+        double frameRate = 0.0;   // frames per second over the last second or so
+    };
+
+    static constexpr double DEFAULT_TARGET_RATE_HZ = 60.0;
+
+    explicit RenderScheduler(QObject* parent = nullptr);
+
+    void setTargetRate(double hz);
+    double getTargetRate() const { return targetRateHz; }
+    void setSyncToDisplay(bool enabled);
+    bool isSyncToDisplay() const { return syncToDisplay; }
+    double getFramePeriodMs() const { return periodNs / 1e6; }
+
+    // Registered widgets are dropped automatically when destroyed
+    void addWidget(QWidget* widget);
+    void removeWidget(QWidget* widget);
+
+    // Repaints widget on the next frame
+    void markDirty(QWidget* widget);
+
+    // Emits frameTick() on the next frame even if nothing is dirty
+    void requestFrame();
+
+    const Statistics& statistics() const { return stats; }
+    void resetStatistics();
+
+signals:
+    // Emitted at the start of every frame, before dirty widgets are repainted
+    void frameTick(qint64 frameTimeNs);
+
+private slots:
+    void onFrame();
+
+private:
+    struct Target {
+        QPointer<QWidget> widget;
+        bool dirty;
+    };
+
+    std::vector<Target> targets;
+    QTimer* frameTimer;
+    QElapsedTimer clock;
+    double targetRateHz;
+    bool syncToDisplay;
+    qint64 periodNs;
+    qint64 nextDeadlineNs;
+    qint64 rateWindowStartNs;
+    int rateWindowFrames;
+    bool frameRequested;
+    bool inFrame;
+    Statistics stats;
+
+    void updatePeriod();
+    void wake();
+    void scheduleFrame();
+    bool hasPendingWork() const;
+};
+
+#endif // RENDERSCHEDULER_H
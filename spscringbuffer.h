@@ -0,0 +1,198 @@
+#ifndef SPSCRINGBUFFER_H
+#define SPSCRINGBUFFER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <vector>
+#include <algorithm>
+
+// Fixed-capacity, lock-free ring buffer for one producer and one consumer.
+//
+// The producer never blocks: once `window` entries are retained, push()
+// silently retires the oldest one, which makes insertion O(1) at steady state.
+// The consumer owns the tail and drops entries from the old end with
+// advanceTailWhile(); readers copy out a consistent snapshot with copyTo().
+// Head and tail live on separate cache lines so the two sides do not
+// false-share. T must be trivially copyable.
+//
+// Bounded mode, for queues where every entry must be consumed exactly once:
+// tryPush() fails instead of retiring the oldest entry and tryPop() hands
+// entries to the consumer one at a time. Use either push()/advanceTailWhile()
+// or tryPush()/tryPop() on a given buffer, not both.
+template <typename T>
+class SpscRingBuffer
+{
+    // Slots are raw storage that is copied into and never destroyed
+    static_assert(std::is_trivially_copyable<T>::value, "SpscRingBuffer requires a trivially copyable T");
+
+public:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    explicit SpscRingBuffer(size_t window)
+        : head(0)
+        , tail(0)
+        , slots(nullptr)
+        , mask(0)
+        , retainedWindow(0)
+    {
+        allocate(window);
+    }
+
+    ~SpscRingBuffer()
+    {
+        release();
+    }
+
+    SpscRingBuffer(const SpscRingBuffer&) = delete;
+    SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+
+    // Producer side
+    void push(const T& value)
+    {
+        uint64_t position = head.load(std::memory_order_relaxed);
+        slots[position & mask] = value;
+        head.store(position + 1, std::memory_order_release);
+    }
+
+    // Producer side, bounded mode. Returns false when `window` entries are
+    // waiting for the consumer.
+    bool tryPush(const T& value)
+    {
+        uint64_t position = head.load(std::memory_order_relaxed);
+        if (position - tail.load(std::memory_order_acquire) >= retainedWindow.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        slots[position & mask] = value;
+        head.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side, bounded mode
+    bool tryPop(T& out)
+    {
+        uint64_t position = tail.load(std::memory_order_relaxed);
+        if (position == head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        out = slots[position & mask];
+        tail.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side: retire entries from the oldest end while pred(entry)
+    // holds. Returns the number of entries removed.
+    template <typename Predicate>
+    size_t advanceTailWhile(Predicate pred)
+    {
+        uint64_t end = head.load(std::memory_order_acquire);
+        uint64_t start = firstValid(end);
+        uint64_t position = start;
+        while (position < end && pred(slots[position & mask])) {
+            ++position;
+        }
+        tail.store(position, std::memory_order_release);
+        return static_cast<size_t>(position - start);
+    }
+
+    // Consumer side
+    void clear()
+    {
+        tail.store(head.load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+    // Copies the retained entries, oldest first. Entries the producer
+    // overwrote while the copy was running are discarded from the front.
+    void copyTo(std::vector<T>& out) const
+    {
+        uint64_t end = head.load(std::memory_order_acquire);
+        uint64_t start = firstValid(end);
+
+        out.resize(static_cast<size_t>(end - start));
+        for (uint64_t position = start; position < end; ++position) {
+            out[static_cast<size_t>(position - start)] = slots[position & mask];
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t newEnd = head.load(std::memory_order_relaxed);
+        uint64_t capacity = mask + 1;
+        // One slot of slack for a write that was in flight during the copy
+        if (newEnd + 1 > start + capacity) {
+            size_t stale = static_cast<size_t>(std::min<uint64_t>(newEnd + 1 - capacity - start, out.size()));
+            out.erase(out.begin(), out.begin() + stale);
+        }
+    }
+
+    size_t size() const
+    {
+        uint64_t end = head.load(std::memory_order_acquire);
+        return static_cast<size_t>(end - firstValid(end));
+    }
+
+    bool empty() const { return size() == 0; }
+    size_t window() const { return retainedWindow.load(std::memory_order_relaxed); }
+    size_t capacity() const { return mask + 1; }
+
+    // Changes the number of retained entries. Growing past the allocated
+    // capacity reallocates and copies the retained entries across, so it
+    // must not race with either side.
+    void setWindow(size_t window)
+    {
+        window = std::max<size_t>(window, 1);
+        if (window + 1 > mask + 1) {
+            std::vector<T> retained;
+            copyTo(retained);
+            release();
+            allocate(window);
+            std::copy(retained.begin(), retained.end(), slots);
+            head.store(retained.size(), std::memory_order_release);
+        } else {
+            retainedWindow.store(window, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> head;   // written by the producer only
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> tail;   // written by the consumer only
+    alignas(CACHE_LINE_SIZE) T* slots;
+    uint64_t mask;
+    std::atomic<size_t> retainedWindow;
+
+    uint64_t firstValid(uint64_t end) const
+    {
+        uint64_t start = tail.load(std::memory_order_acquire);
+        uint64_t limit = retainedWindow.load(std::memory_order_relaxed);
+        if (end - start > limit) {
+            start = end - limit;
+        }
+        return start;
+    }
+
+    void allocate(size_t window)
+    {
+        // Power-of-two capacity with at least one spare slot beyond the window
+        size_t capacity = 1;
+        while (capacity < window + 1) {
+            capacity <<= 1;
+        }
+
+        slots = static_cast<T*>(::operator new[](capacity * sizeof(T), std::align_val_t(CACHE_LINE_SIZE)));
+        for (size_t i = 0; i < capacity; ++i) {
+            new (&slots[i]) T();
+        }
+        mask = capacity - 1;
+        retainedWindow.store(window, std::memory_order_relaxed);
+        head.store(0, std::memory_order_relaxed);
+        tail.store(0, std::memory_order_relaxed);
+    }
+
+    void release()
+    {
+        ::operator delete[](slots, std::align_val_t(CACHE_LINE_SIZE));
+        slots = nullptr;
+    }
+};
+
+#endif // SPSCRINGBUFFER_H
@@ -2,7 +2,10 @@
 #define STRUCTURES_H
 
 #include <QtCore/QDateTime>
+#include <QtCore/QMetaType>
+#include <QtCore/QVector>
 #include <cstdint>
+#include "crc16.h"
 
 // DSP Settings structure for radar configuration
 #pragma pack(push, 1)
@@ -103,21 +106,10 @@ struct DSP_Settings_t {
         reserved6(0)
     {}
     
-    // Calculate CRC16 checksum
+    // Calculate CRC16 checksum (0xA001 reflected, init 0xFFFF) of everything before the checksum field
     uint16_t calculateChecksum() const {
-        const uint8_t* data = reinterpret_cast<const uint8_t*>(this);
         size_t length = sizeof(DSP_Settings_t) - sizeof(checksum) - sizeof(reserved6);
-        uint16_t crc = 0xFFFF;
-        for (size_t i = 0; i < length; i++) {
-            crc ^= data[i];
-            for (int j = 0; j < 8; j++) {
-                if (crc & 1)
-                    crc = (crc >> 1) ^ 0xA001;
-                else
-                    crc >>= 1;
-            }
-        }
-        return crc;
+        return Crc16::compute(this, length);
     }
     
     // Update checksum before sending
@@ -132,6 +124,35 @@ struct DSP_Settings_t {
 };
 #pragma pack(pop)
 
+// Binary detection frame sent by the radar as an alternative to the ASCII
+// "TgtId: .." lines. Little-endian, like the DSPS settings packet:
+//   DetectionFrameHeader_t, then `count` packed DetectionRecord_t
+#pragma pack(push, 1)
+struct DetectionFrameHeader_t {
+    char magic[4];                     // "DETS"
+    uint8_t version;                   // Frame format version (currently 1)
+    uint8_t header_size;               // Size of this header, lets later versions append fields
+    uint16_t count;                    // Number of records following the header
+    uint32_t sequence;                 // Frame sequence number, incremented by the sensor
+    uint16_t checksum;                 // CRC16 (see crc16.h) of the record payload, 0 if not computed
+    uint16_t reserved;                 // Reserved for alignment
+};
+
+struct DetectionRecord_t {
+    uint32_t target_id;                // Target identifier
+    float radius;                      // Distance in meters
+    float radial_speed;                // Speed in m/s
+    float azimuth;                     // Angle in degrees
+    float amplitude;                   // Signal strength in dB
+    int64_t timestamp;                 // Sensor timestamp in ms
+};
+#pragma pack(pop)
+
+static constexpr char DETECTION_FRAME_MAGIC[4] = { 'D', 'E', 'T', 'S' };
+static constexpr uint8_t DETECTION_FRAME_VERSION = 1;
+static_assert(sizeof(DetectionFrameHeader_t) == 16, "DETS header layout changed");
+static_assert(sizeof(DetectionRecord_t) == 28, "DETS record layout changed");
+
 // Structure to hold target detection data
 struct TargetDetection {
     uint32_t target_id;
@@ -155,10 +176,11 @@ struct DetectionData {
     float azimuth;
     float amplitude;
     qint64 timestamp;
+    qint64 receive_time_us;   // local receipt time on LatencyStats' monotonic clock, 0 if unknown
 
-    DetectionData() : target_id(0), radius(0.0), radial_speed(0.0), azimuth(0.0), amplitude(0.0), timestamp(0) {}
+    DetectionData() : target_id(0), radius(0.0), radial_speed(0.0), azimuth(0.0), amplitude(0.0), timestamp(0), receive_time_us(0) {}
     DetectionData(int id, double r, double rs, double az, double amp = 0.0)
-        : target_id(id), radius(r), radial_speed(rs), azimuth(az), amplitude(amp), timestamp(QDateTime::currentMSecsSinceEpoch()) {}
+        : target_id(id), radius(r), radial_speed(rs), azimuth(az), amplitude(amp), timestamp(QDateTime::currentMSecsSinceEpoch()), receive_time_us(0) {}
     
     // Convert to TargetDetection
     TargetDetection toTargetDetection() const {
@@ -166,4 +188,7 @@ struct DetectionData {
     }
 };
 
+// Detection batches travel between threads as implicitly shared QVectors
+Q_DECLARE_METATYPE(DetectionData)
+
 #endif // STRUCTURES_H
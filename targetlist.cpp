@@ -164,6 +164,18 @@ void TargetListWidget::onNewDetection(const DetectionData& detection)
     addTarget(target);
 }
 
+void TargetListWidget::onNewDetections(const QVector<DetectionData>& detections)
+{
+    if (detections.isEmpty()) return;
+
+    // One lock and one display rebuild for the whole batch
+    QMutexLocker locker(&targetsMutex);
+    for (const auto& detection : detections) {
+        addTargetInternal(detection.toTargetDetection());
+    }
+    updateDisplay();
+}
+
 void TargetListWidget::refreshDisplay()
 {
     updateDisplay();
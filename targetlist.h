@@ -48,6 +48,7 @@ signals:
 
 public slots:
     void onNewDetection(const DetectionData& detection);
+    void onNewDetections(const QVector<DetectionData>& detections);
     void refreshDisplay();
 
 private slots:
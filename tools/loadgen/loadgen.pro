@@ -0,0 +1,10 @@
+# Synthetic radar load generator
+QT = core network
+
+TARGET = radar_loadgen
+CONFIG += console c++17
+CONFIG -= app_bundle
+
+include(../../radarcore.pri)
+
+SOURCES += main.cpp
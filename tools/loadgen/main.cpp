@@ -0,0 +1,365 @@
+// Synthetic radar load generator.
+//
+// Simulates a set of moving targets and sends their detections over UDP in
+// the radar's own formats: the "TgtId: .. Range: .. Speed: .. azimuth: ..
+// amplitude: .. timestamp: .." text lines or binary "DETS" frames. Frame
+// rate, burstiness and target count are configurable, so UdpHandler and the
+// GUI can be driven well past field rates on a development machine.
+//
+// Usage: radar_loadgen [--host 127.0.0.1] [--port 5000] [--targets 20]
+//                      [--rate 20] [--burst 1] [--per-packet 32]
+//                      [--format text|binary] [--motion linear|circular|random|mixed]
+//                      [--duration seconds] [--seed n]
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QHostAddress>
+#include <QTimer>
+#include <QUdpSocket>
+#include <QtMath>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "structures.h"
+
+namespace {
+
+enum MotionModel {
+    LinearMotion,     // constant velocity, reflected at the edges of the field of view
+    CircularMotion,   // constant range, sweeping in azimuth
+    RandomMotion,     // random walk in velocity
+    MixedMotion       // one of the above per target
+};
+
+// Field of view covered by the detection chart
+const double MAX_RANGE_M = 100.0;
+const double MIN_RANGE_M = 2.0;
+const double MAX_AZIMUTH_DEG = 90.0;
+
+struct SimulatedTarget {
+    uint32_t id;
+    MotionModel model;
+    double x;              // m, across the boresight
+    double y;              // m, along the boresight
+    double vx;             // m/s
+    double vy;             // m/s
+    double angularRate;    // deg/s, circular motion only
+    double amplitude;      // dB
+};
+
+class TargetSimulator
+{
+public:
+    TargetSimulator(int count, MotionModel model, unsigned seed)
+        : rng(seed)
+    {
+        std::uniform_real_distribution<double> range(MIN_RANGE_M * 2, MAX_RANGE_M * 0.9);
+        std::uniform_real_distribution<double> azimuth(-MAX_AZIMUTH_DEG * 0.9, MAX_AZIMUTH_DEG * 0.9);
+        std::uniform_real_distribution<double> speed(-15.0, 15.0);
+        std::uniform_real_distribution<double> rate(-20.0, 20.0);
+        std::uniform_real_distribution<double> amplitude(30.0, 80.0);
+        std::uniform_int_distribution<int> anyModel(LinearMotion, RandomMotion);
+
+        targets.resize(count);
+        for (int i = 0; i < count; ++i) {
+            SimulatedTarget& target = targets[i];
+            target.id = static_cast<uint32_t>(i + 1);
+            target.model = model == MixedMotion ? static_cast<MotionModel>(anyModel(rng)) : model;
+            double r = range(rng);
+            double a = azimuth(rng) * M_PI / 180.0;
+            target.x = r * std::sin(a);
+            target.y = r * std::cos(a);
+            target.vx = speed(rng);
+            target.vy = speed(rng);
+            target.angularRate = rate(rng);
+            target.amplitude = amplitude(rng);
+        }
+    }
+
+    void advance(double dt)
+    {
+        std::normal_distribution<double> acceleration(0.0, 4.0);
+        std::normal_distribution<double> fluctuation(0.0, 1.0);
+
+        for (auto& target : targets) {
+            switch (target.model) {
+            case CircularMotion: {
+                double r = std::hypot(target.x, target.y);
+                double a = std::atan2(target.x, target.y) + target.angularRate * dt * M_PI / 180.0;
+                if (std::fabs(a) > MAX_AZIMUTH_DEG * M_PI / 180.0) {
+                    target.angularRate = -target.angularRate;
+                    a = std::copysign(MAX_AZIMUTH_DEG * M_PI / 180.0, a);
+                }
+                double x = r * std::sin(a);
+                double y = r * std::cos(a);
+                target.vx = (x - target.x) / dt;
+                target.vy = (y - target.y) / dt;
+                target.x = x;
+                target.y = y;
+                break;
+            }
+            case RandomMotion:
+                target.vx = qBound(-30.0, target.vx + acceleration(rng) * dt, 30.0);
+                target.vy = qBound(-30.0, target.vy + acceleration(rng) * dt, 30.0);
+                move(target, dt);
+                break;
+            default:
+                move(target, dt);
+                break;
+            }
+
+            target.amplitude = qBound(10.0, target.amplitude + fluctuation(rng) * dt * 5.0, 90.0);
+        }
+    }
+
+    // Detection as the radar would report it; positive speed means approaching
+    DetectionData detect(const SimulatedTarget& target, qint64 timestamp) const
+    {
+        double range = std::hypot(target.x, target.y);
+        DetectionData detection;
+        detection.target_id = target.id;
+        detection.radius = static_cast<float>(range);
+        detection.radial_speed = range > 0.0
+            ? static_cast<float>(-(target.x * target.vx + target.y * target.vy) / range)
+            : 0.0f;
+        detection.azimuth = static_cast<float>(std::atan2(target.x, target.y) * 180.0 / M_PI);
+        detection.amplitude = static_cast<float>(target.amplitude);
+        detection.timestamp = timestamp;
+        return detection;
+    }
+
+    const std::vector<SimulatedTarget>& getTargets() const { return targets; }
+
+private:
+    std::vector<SimulatedTarget> targets;
+    std::mt19937 rng;
+
+    static void move(SimulatedTarget& target, double dt)
+    {
+        target.x += target.vx * dt;
+        target.y += target.vy * dt;
+
+        // Reflect off the range limits and the azimuth edges of the field of view
+        double range = std::hypot(target.x, target.y);
+        if (range > MAX_RANGE_M || range < MIN_RANGE_M) {
+            double scale = qBound(MIN_RANGE_M, range, MAX_RANGE_M) / qMax(range, 1e-6);
+            target.x *= scale;
+            target.y *= scale;
+            target.vx = -target.vx;
+            target.vy = -target.vy;
+        }
+        double azimuth = std::atan2(target.x, target.y) * 180.0 / M_PI;
+        if (std::fabs(azimuth) > MAX_AZIMUTH_DEG || target.y < 0.0) {
+            target.y = std::fabs(target.y);
+            target.vx = -target.vx;
+        }
+    }
+};
+
+// Builds datagrams in either protocol into a reused buffer
+class FrameEncoder
+{
+public:
+    explicit FrameEncoder(bool binary) : binary(binary), sequence(0) {}
+
+    const QByteArray& encode(const std::vector<DetectionData>& detections, size_t first, size_t count)
+    {
+        buffer.clear();
+        if (binary) {
+            encodeBinary(detections, first, count);
+        } else {
+            encodeText(detections, first, count);
+        }
+        return buffer;
+    }
+
+private:
+    bool binary;
+    uint32_t sequence;
+    QByteArray buffer;
+
+    void encodeText(const std::vector<DetectionData>& detections, size_t first, size_t count)
+    {
+        char line[192];
+        for (size_t i = first; i < first + count; ++i) {
+            const DetectionData& d = detections[i];
+            int length = std::snprintf(line, sizeof(line),
+                                       "TgtId: %u Range: %.2f Speed: %.2f azimuth: %.2f amplitude: %.1f timestamp: %lld\n",
+                                       d.target_id, d.radius, d.radial_speed, d.azimuth, d.amplitude,
+                                       static_cast<long long>(d.timestamp));
+            buffer.append(line, length);
+        }
+    }
+
+    void encodeBinary(const std::vector<DetectionData>& detections, size_t first, size_t count)
+    {
+        DetectionFrameHeader_t header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, DETECTION_FRAME_MAGIC, sizeof(DETECTION_FRAME_MAGIC));
+        header.version = DETECTION_FRAME_VERSION;
+        header.header_size = sizeof(DetectionFrameHeader_t);
+        header.count = static_cast<uint16_t>(count);
+        header.sequence = sequence++;
+        buffer.append(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        for (size_t i = first; i < first + count; ++i) {
+            const DetectionData& d = detections[i];
+            DetectionRecord_t record;
+            record.target_id = d.target_id;
+            record.radius = d.radius;
+            record.radial_speed = d.radial_speed;
+            record.azimuth = d.azimuth;
+            record.amplitude = d.amplitude;
+            record.timestamp = d.timestamp;
+            buffer.append(reinterpret_cast<const char*>(&record), sizeof(record));
+        }
+
+        // Checksum over the records, patched into the header written above
+        uint16_t checksum = Crc16::compute(buffer.constData() + sizeof(header), buffer.size() - sizeof(header));
+        std::memcpy(buffer.data() + offsetof(DetectionFrameHeader_t, checksum), &checksum, sizeof(checksum));
+    }
+};
+
+MotionModel parseMotion(const QString& name, bool* ok)
+{
+    *ok = true;
+    if (name == "linear") return LinearMotion;
+    if (name == "circular") return CircularMotion;
+    if (name == "random") return RandomMotion;
+    if (name == "mixed") return MixedMotion;
+    *ok = false;
+    return LinearMotion;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("Zoppler Radar Load Generator");
+    app.setApplicationVersion("1.1");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Sends simulated radar detections over UDP.");
+    parser.addHelpOption();
+    parser.addVersionOption();
+
+    QCommandLineOption hostOption("host", "Destination address.", "address", "127.0.0.1");
+    QCommandLineOption portOption("port", "Destination UDP port.", "port", "5000");
+    QCommandLineOption targetsOption("targets", "Number of simulated targets.", "count", "20");
+    QCommandLineOption rateOption("rate", "Radar frames per second; every frame reports every target.", "fps", "20");
+    QCommandLineOption burstOption("burst", "Frames sent back to back per burst; bursts keep the average rate.", "frames", "1");
+    QCommandLineOption perPacketOption("per-packet", "Maximum detections per datagram.", "count", "32");
+    QCommandLineOption formatOption("format", "Wire format: text or binary.", "format", "text");
+    QCommandLineOption motionOption("motion", "Motion model: linear, circular, random or mixed.", "model", "mixed");
+    QCommandLineOption durationOption("duration", "Stop after this many seconds (default: run until interrupted).",
+                                      "seconds", "0");
+    QCommandLineOption seedOption("seed", "Random seed for reproducible scenarios.", "n", "1");
+    parser.addOption(hostOption);
+    parser.addOption(portOption);
+    parser.addOption(targetsOption);
+    parser.addOption(rateOption);
+    parser.addOption(burstOption);
+    parser.addOption(perPacketOption);
+    parser.addOption(formatOption);
+    parser.addOption(motionOption);
+    parser.addOption(durationOption);
+    parser.addOption(seedOption);
+    parser.process(app);
+
+    QHostAddress host(parser.value(hostOption));
+    quint16 port = static_cast<quint16>(parser.value(portOption).toUInt());
+    int targetCount = qMax(1, parser.value(targetsOption).toInt());
+    double frameRate = qMax(0.1, parser.value(rateOption).toDouble());
+    int burst = qMax(1, parser.value(burstOption).toInt());
+    size_t perPacket = static_cast<size_t>(qMax(1, parser.value(perPacketOption).toInt()));
+    QString format = parser.value(formatOption);
+    bool motionOk = false;
+    MotionModel motion = parseMotion(parser.value(motionOption), &motionOk);
+
+    if (host.isNull() || port == 0 || !motionOk || (format != "text" && format != "binary")) {
+        parser.showHelp(1);
+    }
+
+    // A DETS frame counts its records in 16 bits; stay well inside one datagram
+    if (format == "binary") {
+        perPacket = qMin(perPacket, size_t(2000));
+    }
+
+    QUdpSocket socket;
+    TargetSimulator simulator(targetCount, motion, parser.value(seedOption).toUInt());
+    FrameEncoder encoder(format == "binary");
+    std::vector<DetectionData> frame;
+    frame.reserve(targetCount);
+
+    QElapsedTimer clock;
+    clock.start();
+    double frameInterval = 1.0 / frameRate;
+    quint64 framesSent = 0;
+
+    // Statistics since the last report
+    quint64 datagrams = 0;
+    quint64 detections = 0;
+    quint64 bytes = 0;
+    quint64 sendErrors = 0;
+
+    auto sendFrame = [&]() {
+        qint64 timestamp = QDateTime::currentMSecsSinceEpoch();
+        simulator.advance(frameInterval);
+
+        frame.clear();
+        for (const auto& target : simulator.getTargets()) {
+            frame.push_back(simulator.detect(target, timestamp));
+        }
+
+        for (size_t first = 0; first < frame.size(); first += perPacket) {
+            size_t count = qMin(perPacket, frame.size() - first);
+            const QByteArray& datagram = encoder.encode(frame, first, count);
+            if (socket.writeDatagram(datagram, host, port) < 0) {
+                sendErrors++;
+                continue;
+            }
+            datagrams++;
+            detections += count;
+            bytes += static_cast<quint64>(datagram.size());
+        }
+        framesSent++;
+    };
+
+    // Bursts are due every `burst` frame intervals; catch up if the timer runs late
+    QTimer sendTimer;
+    sendTimer.setTimerType(Qt::PreciseTimer);
+    QObject::connect(&sendTimer, &QTimer::timeout, [&]() {
+        double elapsed = clock.nsecsElapsed() / 1e9;
+        quint64 burstsDue = static_cast<quint64>(elapsed / (frameInterval * burst)) + 1;
+        while (framesSent < burstsDue * burst) {
+            sendFrame();
+        }
+    });
+    sendTimer.start(qBound(1, static_cast<int>(frameInterval * burst * 1000.0 / 4), 50));
+
+    QTimer reportTimer;
+    QElapsedTimer reportClock;
+    reportClock.start();
+    QObject::connect(&reportTimer, &QTimer::timeout, [&]() {
+        double seconds = reportClock.nsecsElapsed() / 1e9;
+        reportClock.restart();
+        fprintf(stderr, "%.0f datagrams/s  %.0f detections/s  %.1f KiB/s  send errors: %llu\n",
+                datagrams / seconds, detections / seconds, bytes / seconds / 1024.0,
+                static_cast<unsigned long long>(sendErrors));
+        datagrams = detections = bytes = sendErrors = 0;
+    });
+    reportTimer.start(1000);
+
+    int durationSeconds = parser.value(durationOption).toInt();
+    if (durationSeconds > 0) {
+        QTimer::singleShot(durationSeconds * 1000, &app, &QCoreApplication::quit);
+    }
+
+    return app.exec();
+}
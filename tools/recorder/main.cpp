@@ -0,0 +1,234 @@
+// Headless detection recorder.
+//
+// Receives the radar's detection datagrams with the same UdpHandler the GUI
+// uses and writes every detection as one CSV row. Needs no display, so it
+// runs on the logging boxes.
+//
+// Usage: radar_recorder [--host 0.0.0.0] [--port 5000] [--output detections.csv]
+//                       [--duration seconds] [--capture session.rcap]
+//        radar_recorder --replay session.rcap [--speed 1|N|max] [--output detections.csv]
+//
+// --capture additionally keeps every raw datagram in a binary capture.
+// --replay feeds a capture through the ingest path instead of the socket;
+// with --speed max it reports the achieved ingest throughput.
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTextStream>
+#include <QTimer>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#ifdef Q_OS_UNIX
+#include <QSocketNotifier>
+#include <sys/socket.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+#include "udphandler.h"
+#include "capturerecorder.h"
+#include "capturereplay.h"
+
+namespace {
+
+#ifdef Q_OS_UNIX
+// Written by the signal handler, read by the event loop
+int signalFds[2] = { -1, -1 };
+
+// Only async-signal-safe calls here: the event loop does the actual quit
+void handleSignal(int)
+{
+    int savedErrno = errno;
+    char byte = 1;
+    ssize_t written = ::write(signalFds[0], &byte, sizeof(byte));
+    Q_UNUSED(written);
+    errno = savedErrno;
+}
+#else
+// Console control handlers run on their own thread, so a queued call is enough
+void handleSignal(int)
+{
+    QMetaObject::invokeMethod(QCoreApplication::instance(), "quit", Qt::QueuedConnection);
+}
+#endif
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("Zoppler Radar Recorder");
+    app.setApplicationVersion("1.1");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Records radar detections to CSV without a display.");
+    parser.addHelpOption();
+    parser.addVersionOption();
+
+    QCommandLineOption hostOption("host", "Local address to bind to.", "address", "0.0.0.0");
+    QCommandLineOption portOption("port", "UDP port to listen on.", "port", "5000");
+    QCommandLineOption outputOption({"o", "output"}, "CSV file to write (default: stdout).", "file");
+    QCommandLineOption durationOption("duration", "Stop after this many seconds (default: run until interrupted).",
+                                      "seconds", "0");
+    QCommandLineOption captureOption("capture", "Also record raw datagrams to this capture file.", "file");
+    QCommandLineOption replayOption("replay", "Replay this capture instead of listening on the network.", "file");
+    QCommandLineOption speedOption("speed", "Replay speed factor, or 'max'.", "factor", "1");
+    parser.addOption(hostOption);
+    parser.addOption(portOption);
+    parser.addOption(outputOption);
+    parser.addOption(durationOption);
+    parser.addOption(captureOption);
+    parser.addOption(replayOption);
+    parser.addOption(speedOption);
+    parser.process(app);
+
+    bool portOk = false;
+    int port = parser.value(portOption).toInt(&portOk);
+    if (!portOk || port < 1 || port > 65535) {
+        fprintf(stderr, "Invalid port: %s\n", qPrintable(parser.value(portOption)));
+        return 1;
+    }
+
+    QFile output;
+    bool opened = false;
+    if (parser.isSet(outputOption)) {
+        output.setFileName(parser.value(outputOption));
+        opened = output.open(QIODevice::WriteOnly | QIODevice::Text);
+    } else {
+        opened = output.open(stdout, QIODevice::WriteOnly | QIODevice::Text);
+    }
+    if (!opened) {
+        fprintf(stderr, "Cannot open output: %s\n", qPrintable(output.errorString()));
+        return 1;
+    }
+
+    QTextStream csv(&output);
+    csv << "receive_time_ms,target_id,range_m,radial_speed_mps,azimuth_deg,amplitude_db,timestamp_ms\n";
+
+    UdpHandler udpHandler;
+    CaptureReplay captureReplay(&udpHandler);
+    bool replaying = parser.isSet(replayOption);
+
+    // A replayed datagram keeps the receive time it was captured with
+    QObject::connect(&udpHandler, &UdpHandler::detectionsBatchReceived,
+                     [&csv, &captureReplay, replaying](const QVector<DetectionData>& detections) {
+        qint64 receiveTime = replaying ? captureReplay.getCurrentTimeUs() / 1000
+                                       : QDateTime::currentMSecsSinceEpoch();
+        for (const auto& detection : detections) {
+            csv << receiveTime << ','
+                << detection.target_id << ','
+                << detection.radius << ','
+                << detection.radial_speed << ','
+                << detection.azimuth << ','
+                << detection.amplitude << ','
+                << detection.timestamp << '\n';
+        }
+    });
+    QObject::connect(&udpHandler, &UdpHandler::errorOccurred, [](const QString& error) {
+        fprintf(stderr, "%s\n", qPrintable(error));
+    });
+    // Flush once per statistics tick rather than per datagram
+    QObject::connect(&udpHandler, &UdpHandler::statisticsUpdated,
+                     [&csv, &udpHandler](int packetsReceived, int packetsDropped, double dataRate) {
+        csv.flush();
+        fprintf(stderr, "packets: %d  dropped: %d  detections dropped: %d  rate: %.1f pps\n",
+                packetsReceived, packetsDropped, udpHandler.getDetectionsDropped(), dataRate);
+    });
+
+    CaptureRecorder captureRecorder;
+    QElapsedTimer replayClock;
+
+    if (replaying) {
+        // 0 is CaptureReplay's "as fast as possible"
+        QString speedText = parser.value(speedOption);
+        bool speedOk = true;
+        double speed = 0.0;
+        if (speedText != "max") {
+            speed = speedText.toDouble(&speedOk);
+            speedOk = speedOk && std::isfinite(speed) && speed > 0.0;
+        }
+        if (!speedOk) {
+            fprintf(stderr, "Invalid speed: %s\n", qPrintable(speedText));
+            return 1;
+        }
+
+        QString error;
+        if (!captureReplay.open(parser.value(replayOption), &error)) {
+            fprintf(stderr, "Cannot open capture: %s\n", qPrintable(error));
+            return 1;
+        }
+        captureReplay.setSpeed(speed);
+        captureReplay.setBatchPerDatagram(true);
+        QObject::connect(&captureReplay, &CaptureReplay::errorOccurred, [](const QString& error) {
+            fprintf(stderr, "%s\n", qPrintable(error));
+        });
+        QObject::connect(&captureReplay, &CaptureReplay::finished, [&]() {
+            double seconds = replayClock.nsecsElapsed() / 1e9;
+            fprintf(stderr, "replayed %llu datagrams in %.3f s (%.0f datagrams/s)\n",
+                    static_cast<unsigned long long>(captureReplay.getDatagramsReplayed()), seconds,
+                    seconds > 0.0 ? captureReplay.getDatagramsReplayed() / seconds : 0.0);
+            QCoreApplication::quit();
+        });
+        replayClock.start();
+        captureReplay.start();
+    } else {
+        if (parser.isSet(captureOption)) {
+            QString error;
+            if (!captureRecorder.start(parser.value(captureOption), &error)) {
+                fprintf(stderr, "Cannot start capture: %s\n", qPrintable(error));
+                return 1;
+            }
+            QObject::connect(&captureRecorder, &CaptureRecorder::errorOccurred, [](const QString& error) {
+                fprintf(stderr, "%s\n", qPrintable(error));
+            });
+            udpHandler.setCaptureRecorder(&captureRecorder);
+        }
+
+        if (!udpHandler.connectToHost(parser.value(hostOption), port)) {
+            return 1;
+        }
+    }
+
+    int durationSeconds = parser.value(durationOption).toInt();
+    if (durationSeconds > 0) {
+        QTimer::singleShot(durationSeconds * 1000, &app, &QCoreApplication::quit);
+    }
+
+#ifdef Q_OS_UNIX
+    if (::socketpair(AF_UNIX, SOCK_STREAM, 0, signalFds) != 0) {
+        fprintf(stderr, "Cannot create signal socket pair\n");
+        return 1;
+    }
+    // A burst of signals must never block the handler on a full socket
+    ::fcntl(signalFds[0], F_SETFL, ::fcntl(signalFds[0], F_GETFL) | O_NONBLOCK);
+    QSocketNotifier signalNotifier(signalFds[1], QSocketNotifier::Read);
+    auto onSignal = [&signalNotifier]() {
+        signalNotifier.setEnabled(false);
+        char byte;
+        ssize_t received = ::read(signalFds[1], &byte, sizeof(byte));
+        Q_UNUSED(received);
+        QCoreApplication::quit();
+    };
+#if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0) && QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    QObject::connect(&signalNotifier,
+                     QOverload<QSocketDescriptor, QSocketNotifier::Type>::of(&QSocketNotifier::activated), onSignal);
+#else
+    QObject::connect(&signalNotifier, &QSocketNotifier::activated, onSignal);
+#endif
+#endif
+
+    std::signal(SIGINT, handleSignal);
+    std::signal(SIGTERM, handleSignal);
+
+    int result = app.exec();
+
+    udpHandler.disconnectFromHost();
+    udpHandler.setCaptureRecorder(nullptr);
+    captureRecorder.stop();
+    csv.flush();
+    return result;
+}
@@ -0,0 +1,15 @@
+# Headless detection recorder
+QT = core network
+
+TARGET = radar_recorder
+CONFIG += console c++17
+CONFIG -= app_bundle
+
+include(../../radarcore.pri)
+
+SOURCES += main.cpp
+
+linux {
+    target.path = /usr/local/bin
+    INSTALLS += target
+}
@@ -0,0 +1,354 @@
+#include "trackassociator.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const double UNASSIGNABLE = 1e9;   // cost of a pair outside the gate
+const double NEW_TRACK_COST = 1.0; // cost of leaving a detection unassigned: the gate edge
+const int MAX_RANGE_CELLS = 1024;
+
+inline double square(double value) { return value * value; }
+
+} // namespace
+
+// TrackAssociator Implementation
+TrackAssociator::TrackAssociator()
+    : TrackAssociator(Gates())
+{
+}
+
+TrackAssociator::TrackAssociator(const Gates& gates)
+    : nextId(1)
+    , rangeCells(1)
+    , azimuthCells(1)
+{
+    setGates(gates);
+}
+
+void TrackAssociator::setGates(const Gates& newGates)
+{
+    gates = newGates;
+    gates.rangeM = qMax(gates.rangeM, 0.01);
+    gates.azimuthDeg = qMax(gates.azimuthDeg, 0.01);
+    gates.radialSpeedMps = qMax(gates.radialSpeedMps, 0.01);
+    azimuthCells = static_cast<int>(std::ceil(360.0 / gates.azimuthDeg));
+}
+
+void TrackAssociator::reset()
+{
+    tracks.clear();
+    nextId = 1;
+    stats = Statistics();
+}
+
+void TrackAssociator::associate(DetectionData* detections, size_t count, qint64 timeUs)
+{
+    stats.frames++;
+    stats.detections += count;
+
+    // Tracks that went quiet must not capture new detections
+    tracks.erase(std::remove_if(tracks.begin(), tracks.end(), [timeUs](const Track& track) {
+        return timeUs - track.lastTimeUs > TRACK_TIMEOUT_US;
+    }), tracks.end());
+
+    if (count == 0) {
+        return;
+    }
+
+    buildGrid(timeUs);
+    collectEdges(detections, count);
+
+    // Pairs that only gate each other need no solver
+    assignedTrack.assign(count, -1);
+    contested.clear();
+    for (size_t i = 0; i < count; ++i) {
+        int edgeCount = edgeStart[i + 1] - edgeStart[i];
+        if (edgeCount == 0) {
+            continue;
+        }
+        int track = edges[edgeStart[i]].track;
+        if (edgeCount == 1 && trackHits[track] == 1) {
+            assignedTrack[i] = track;
+            stats.directAssignments++;
+        } else {
+            contested.push_back(static_cast<int>(i));
+        }
+    }
+
+    if (!contested.empty()) {
+        solveContested(count);
+    }
+
+    applyAssignments(detections, count, timeUs);
+}
+
+int TrackAssociator::cellIndex(double radius, double azimuth) const
+{
+    int rangeCell = qBound(0, static_cast<int>(radius / gates.rangeM), rangeCells - 1);
+    int azimuthCell = qBound(0, static_cast<int>((azimuth + 180.0) / gates.azimuthDeg), azimuthCells - 1);
+    return rangeCell * azimuthCells + azimuthCell;
+}
+
+void TrackAssociator::buildGrid(qint64 timeUs)
+{
+    // Predict every track to the frame time along its radial speed
+    double maxRange = 0.0;
+    for (auto& track : tracks) {
+        double dt = timeUs > track.lastTimeUs ? (timeUs - track.lastTimeUs) / 1e6 : 0.0;
+        track.predictedRadius = qMax(0.0f, static_cast<float>(track.radius - track.radialSpeed * dt));
+        maxRange = qMax(maxRange, static_cast<double>(track.predictedRadius));
+    }
+
+    // Anything beyond the farthest track shares the last row, which keeps
+    // the grid as small as the scene
+    rangeCells = qBound(1, static_cast<int>(maxRange / gates.rangeM) + 2, MAX_RANGE_CELLS);
+    int cellCount = rangeCells * azimuthCells;
+
+    // Counting sort of the tracks by cell
+    cellStart.assign(cellCount + 1, 0);
+    trackCell.resize(tracks.size());
+    for (size_t t = 0; t < tracks.size(); ++t) {
+        int cell = cellIndex(tracks[t].predictedRadius, tracks[t].azimuth);
+        trackCell[t] = cell;
+        cellStart[cell + 1]++;
+    }
+    for (int cell = 0; cell < cellCount; ++cell) {
+        cellStart[cell + 1] += cellStart[cell];
+    }
+    cellTracks.resize(tracks.size());
+    for (size_t t = 0; t < tracks.size(); ++t) {
+        cellTracks[cellStart[trackCell[t]]++] = static_cast<int>(t);
+    }
+    for (int cell = cellCount; cell > 0; --cell) {
+        cellStart[cell] = cellStart[cell - 1];
+    }
+    cellStart[0] = 0;
+}
+
+void TrackAssociator::collectEdges(const DetectionData* detections, size_t count)
+{
+    edges.clear();
+    edgeStart.resize(count + 1);
+    trackHits.assign(tracks.size(), 0);
+
+    for (size_t i = 0; i < count; ++i) {
+        const DetectionData& detection = detections[i];
+        edgeStart[i] = static_cast<int>(edges.size());
+
+        int home = cellIndex(detection.radius, detection.azimuth);
+        int homeRange = home / azimuthCells;
+        int homeAzimuth = home % azimuthCells;
+
+        // A gate is one cell wide, so every candidate lies in the 3x3 neighbourhood
+        for (int rangeCell = qMax(0, homeRange - 1); rangeCell <= qMin(rangeCells - 1, homeRange + 1); ++rangeCell) {
+            for (int azimuthCell = qMax(0, homeAzimuth - 1); azimuthCell <= qMin(azimuthCells - 1, homeAzimuth + 1); ++azimuthCell) {
+                int cell = rangeCell * azimuthCells + azimuthCell;
+                for (int k = cellStart[cell]; k < cellStart[cell + 1]; ++k) {
+                    int t = cellTracks[k];
+                    const Track& track = tracks[t];
+                    double cost = square((detection.radius - track.predictedRadius) / gates.rangeM) +
+                                  square((detection.azimuth - track.azimuth) / gates.azimuthDeg) +
+                                  square((detection.radial_speed - track.radialSpeed) / gates.radialSpeedMps);
+                    if (cost <= 1.0) {
+                        edges.push_back({ t, static_cast<float>(cost) });
+                        trackHits[t]++;
+                    }
+                }
+            }
+        }
+    }
+    edgeStart[count] = static_cast<int>(edges.size());
+}
+
+int TrackAssociator::findRoot(int node)
+{
+    int root = node;
+    while (parent[root] != root) {
+        root = parent[root];
+    }
+    while (parent[node] != root) {
+        int next = parent[node];
+        parent[node] = root;
+        node = next;
+    }
+    return root;
+}
+
+void TrackAssociator::solveContested(size_t count)
+{
+    // Clusters are the connected components of the gate graph; nodes are
+    // detections [0, count) followed by tracks
+    int trackBase = static_cast<int>(count);
+    parent.resize(count + tracks.size());
+    for (size_t node = 0; node < parent.size(); ++node) {
+        parent[node] = static_cast<int>(node);
+    }
+    for (int detection : contested) {
+        for (int e = edgeStart[detection]; e < edgeStart[detection + 1]; ++e) {
+            int a = findRoot(detection);
+            int b = findRoot(trackBase + edges[e].track);
+            if (a != b) {
+                parent[b] = a;
+            }
+        }
+    }
+    for (int detection : contested) {
+        findRoot(detection);
+    }
+    std::sort(contested.begin(), contested.end(), [this](int a, int b) {
+        return parent[a] != parent[b] ? parent[a] < parent[b] : a < b;
+    });
+
+    trackSlot.assign(tracks.size(), -1);
+    size_t first = 0;
+    while (first < contested.size()) {
+        size_t last = first + 1;
+        while (last < contested.size() && parent[contested[last]] == parent[contested[first]]) {
+            ++last;
+        }
+        stats.contestedClusters++;
+        solveCluster(&contested[first], static_cast<int>(last - first));
+        first = last;
+    }
+}
+
+void TrackAssociator::solveCluster(const int* clusterDetections, int detectionCount)
+{
+    clusterTracks.clear();
+    for (int row = 0; row < detectionCount; ++row) {
+        int detection = clusterDetections[row];
+        for (int e = edgeStart[detection]; e < edgeStart[detection + 1]; ++e) {
+            int track = edges[e].track;
+            if (trackSlot[track] < 0) {
+                trackSlot[track] = static_cast<int>(clusterTracks.size());
+                clusterTracks.push_back(track);
+            }
+        }
+    }
+    int trackCount = static_cast<int>(clusterTracks.size());
+
+    if (detectionCount > MAX_SOLVER_SIZE || trackCount > MAX_SOLVER_SIZE) {
+        solveGreedy(clusterDetections, detectionCount);
+    } else {
+        // Rows are detections; columns are the cluster's tracks followed by
+        // one "new track" column per detection, so every row can be matched
+        int rows = detectionCount;
+        int cols = trackCount + detectionCount;
+        costMatrix.assign(static_cast<size_t>(rows) * cols, UNASSIGNABLE);
+        for (int row = 0; row < rows; ++row) {
+            int detection = clusterDetections[row];
+            for (int e = edgeStart[detection]; e < edgeStart[detection + 1]; ++e) {
+                costMatrix[row * cols + trackSlot[edges[e].track]] = edges[e].cost;
+            }
+            costMatrix[row * cols + trackCount + row] = NEW_TRACK_COST;
+        }
+
+        // Hungarian algorithm with potentials, O(rows^2 * cols); 1-based
+        // with row/column 0 as the virtual start
+        potentialRows.assign(rows + 1, 0.0);
+        potentialCols.assign(cols + 1, 0.0);
+        matchedRow.assign(cols + 1, 0);
+        way.assign(cols + 1, 0);
+        for (int row = 1; row <= rows; ++row) {
+            matchedRow[0] = row;
+            int col0 = 0;
+            minSlack.assign(cols + 1, UNASSIGNABLE * 2);
+            usedCols.assign(cols + 1, 0);
+            do {
+                usedCols[col0] = 1;
+                int row0 = matchedRow[col0];
+                double delta = UNASSIGNABLE * 2;
+                int col1 = 0;
+                for (int col = 1; col <= cols; ++col) {
+                    if (usedCols[col]) continue;
+                    double slack = costMatrix[(row0 - 1) * cols + (col - 1)] - potentialRows[row0] - potentialCols[col];
+                    if (slack < minSlack[col]) {
+                        minSlack[col] = slack;
+                        way[col] = col0;
+                    }
+                    if (minSlack[col] < delta) {
+                        delta = minSlack[col];
+                        col1 = col;
+                    }
+                }
+                for (int col = 0; col <= cols; ++col) {
+                    if (usedCols[col]) {
+                        potentialRows[matchedRow[col]] += delta;
+                        potentialCols[col] -= delta;
+                    } else {
+                        minSlack[col] -= delta;
+                    }
+                }
+                col0 = col1;
+            } while (matchedRow[col0] != 0);
+            do {
+                int col1 = way[col0];
+                matchedRow[col0] = matchedRow[col1];
+                col0 = col1;
+            } while (col0 != 0);
+        }
+
+        for (int col = 1; col <= trackCount; ++col) {
+            int row = matchedRow[col];
+            if (row != 0 && costMatrix[(row - 1) * cols + (col - 1)] < UNASSIGNABLE) {
+                assignedTrack[clusterDetections[row - 1]] = clusterTracks[col - 1];
+                stats.solvedAssignments++;
+            }
+        }
+    }
+
+    for (int track : clusterTracks) {
+        trackSlot[track] = -1;
+    }
+}
+
+void TrackAssociator::solveGreedy(const int* clusterDetections, int detectionCount)
+{
+    // Cheapest pairs first; trackSlot doubles as the "taken" mark
+    greedyEdges.clear();
+    for (int row = 0; row < detectionCount; ++row) {
+        int detection = clusterDetections[row];
+        for (int e = edgeStart[detection]; e < edgeStart[detection + 1]; ++e) {
+            greedyEdges.push_back({ edges[e].cost, detection, edges[e].track });
+        }
+    }
+    std::sort(greedyEdges.begin(), greedyEdges.end(), [](const GreedyEdge& a, const GreedyEdge& b) {
+        return a.cost < b.cost;
+    });
+
+    const int TAKEN = -2;
+    for (const auto& edge : greedyEdges) {
+        if (assignedTrack[edge.detection] < 0 && trackSlot[edge.track] != TAKEN) {
+            assignedTrack[edge.detection] = edge.track;
+            trackSlot[edge.track] = TAKEN;
+            stats.solvedAssignments++;
+        }
+    }
+}
+
+void TrackAssociator::applyAssignments(DetectionData* detections, size_t count, qint64 timeUs)
+{
+    for (size_t i = 0; i < count; ++i) {
+        DetectionData& detection = detections[i];
+        int t = assignedTrack[i];
+        if (t < 0) {
+            Track track;
+            track.id = nextId++;
+            if (nextId == 0) {
+                nextId = 1;
+            }
+            tracks.push_back(track);
+            t = static_cast<int>(tracks.size() - 1);
+            stats.newTracks++;
+        }
+
+        Track& track = tracks[t];
+        track.radius = detection.radius;
+        track.azimuth = detection.azimuth;
+        track.radialSpeed = detection.radial_speed;
+        track.lastTimeUs = timeUs;
+        track.predictedRadius = detection.radius;
+        detection.target_id = track.id;
+    }
+}
@@ -0,0 +1,125 @@
+#ifndef TRACKASSOCIATOR_H
+#define TRACKASSOCIATOR_H
+
+#include <QtGlobal>
+#include <cstddef>
+#include <vector>
+#include "structures.h"
+
+// Gated nearest-neighbour association for sensors without stable target IDs.
+//
+// associate() takes the detections of one radar frame and overwrites their
+// target_id with the ID of the track each one continues; detections that
+// continue no track start a new one. IDs are allocated here from 1 upwards
+// and never depend on the sensor's own TgtId.
+//
+// A track is predicted to the frame time along its radial speed (positive
+// when approaching), then gated on the normalised distance
+//   d^2 = (dRange / rangeM)^2 + (dAzimuth / azimuthDeg)^2 + (dSpeed / radialSpeedMps)^2 <= 1.
+// Predicted tracks are binned into a uniform range/azimuth grid with one
+// gate per cell, so each detection only looks at the 3x3 cells around it
+// and a frame costs O(detections + tracks) rather than O(detections * tracks).
+// A detection and a track that only gate each other are paired directly.
+// Clusters where gates overlap are solved optimally with the Hungarian
+// algorithm, where leaving a detection unassigned costs as much as the gate
+// edge; clusters larger than MAX_SOLVER_SIZE fall back to greedy pairing by
+// cost. Tracks not continued for TRACK_TIMEOUT_US are dropped.
+//
+// Times are microseconds on a monotonic clock. Scratch buffers are reused,
+// so steady-state frames do not allocate. Not thread-safe: each ingest
+// thread owns its own associator.
+class TrackAssociator
+{
+public:
+    struct Gates {
+        double rangeM = 2.0;
+        double azimuthDeg = 4.0;
+        double radialSpeedMps = 3.0;
+    };
+
+    struct Statistics {
+        quint64 frames = 0;
+        quint64 detections = 0;
+        quint64 directAssignments = 0;   // uncontested gates
+        quint64 solvedAssignments = 0;   // assigned inside a contested cluster
+        quint64 newTracks = 0;
+        quint64 contestedClusters = 0;
+    };
+
+    static constexpr qint64 TRACK_TIMEOUT_US = 1000000;
+    static constexpr int MAX_SOLVER_SIZE = 64;
+
+    TrackAssociator();
+    explicit TrackAssociator(const Gates& gates);
+
+    void setGates(const Gates& gates);
+    const Gates& getGates() const { return gates; }
+
+    void associate(DetectionData* detections, size_t count, qint64 timeUs);
+    void reset();
+
+    int trackCount() const { return static_cast<int>(tracks.size()); }
+    const Statistics& statistics() const { return stats; }
+
+private:
+    struct Track {
+        quint32 id;
+        float radius;
+        float azimuth;
+        float radialSpeed;
+        qint64 lastTimeUs;
+        float predictedRadius;   // at the current frame time
+    };
+
+    struct Edge {
+        int track;
+        float cost;
+    };
+
+    struct GreedyEdge {
+        float cost;
+        int detection;
+        int track;
+    };
+
+    Gates gates;
+    Statistics stats;
+    std::vector<Track> tracks;
+    quint32 nextId;
+
+    // Grid of predicted track positions, in compressed row form
+    int rangeCells;
+    int azimuthCells;
+    std::vector<int> cellStart;   // rangeCells * azimuthCells + 1 offsets into cellTracks
+    std::vector<int> cellTracks;
+    std::vector<int> trackCell;
+
+    // Per-frame scratch
+    std::vector<Edge> edges;
+    std::vector<int> edgeStart;          // detection i owns edges[edgeStart[i], edgeStart[i + 1])
+    std::vector<int> trackHits;          // gating detections per track
+    std::vector<int> assignedTrack;      // per detection, -1 for a new track
+    std::vector<int> parent;             // union-find over detections and tracks
+    std::vector<int> contested;
+    std::vector<int> clusterTracks;
+    std::vector<int> trackSlot;          // track index -> column inside the current cluster
+    std::vector<double> costMatrix;
+    std::vector<double> potentialRows;
+    std::vector<double> potentialCols;
+    std::vector<int> matchedRow;
+    std::vector<int> way;
+    std::vector<double> minSlack;
+    std::vector<char> usedCols;
+    std::vector<GreedyEdge> greedyEdges;
+
+    int cellIndex(double radius, double azimuth) const;
+    void buildGrid(qint64 timeUs);
+    void collectEdges(const DetectionData* detections, size_t count);
+    int findRoot(int node);
+    void solveContested(size_t count);
+    void solveCluster(const int* clusterDetections, int detectionCount);
+    void solveGreedy(const int* clusterDetections, int detectionCount);
+    void applyAssignments(DetectionData* detections, size_t count, qint64 timeUs);
+};
+
+#endif // TRACKASSOCIATOR_H
@@ -0,0 +1,230 @@
+#include "trackfilter.h"
+#include <cmath>
+
+namespace {
+
+const double DEG_TO_RAD = M_PI / 180.0;
+const double MIN_RANGE = 1e-3;   // radial speed is undefined at the origin
+
+inline double square(double value) { return value * value; }
+
+// Keeps P symmetric against rounding drift
+void symmetrize(TrackFilter::Covariance& p)
+{
+    for (int row = 0; row < 4; ++row) {
+        for (int col = row + 1; col < 4; ++col) {
+            double mean = 0.5 * (p(row, col) + p(col, row));
+            p(row, col) = mean;
+            p(col, row) = mean;
+        }
+    }
+}
+
+} // namespace
+
+// TrackFilter Implementation
+void TrackFilter::reset()
+{
+    stateVector = State();
+    covarianceMatrix = Covariance();
+    lastTimeUs = 0;
+    initialized = false;
+}
+
+void TrackFilter::polarToCartesian(double radius, double azimuthDeg, double& x, double& y)
+{
+    double azimuth = azimuthDeg * DEG_TO_RAD;
+    x = radius * std::sin(azimuth);
+    y = radius * std::cos(azimuth);
+}
+
+void TrackFilter::cartesianToPolar(double x, double y, double& radius, double& azimuthDeg)
+{
+    radius = std::hypot(x, y);
+    azimuthDeg = std::atan2(x, y) / DEG_TO_RAD;
+}
+
+void TrackFilter::update(double radius, double azimuthDeg, double radialSpeed, qint64 timeUs, const Noise& noise)
+{
+    if (!initialized || timeUs - lastTimeUs > RESTART_GAP_US) {
+        initialize(radius, azimuthDeg, radialSpeed, timeUs, noise);
+        return;
+    }
+
+    // Detections that arrive out of order are applied at the latest time
+    if (timeUs > lastTimeUs) {
+        predict((timeUs - lastTimeUs) / 1e6, noise);
+        lastTimeUs = timeUs;
+    }
+    updatePosition(radius, azimuthDeg, noise);
+    updateRadialSpeed(radialSpeed, noise);
+}
+
+void TrackFilter::predictPosition(qint64 timeUs, double& x, double& y) const
+{
+    double dt = timeUs > lastTimeUs ? (timeUs - lastTimeUs) / 1e6 : 0.0;
+    x = stateVector(0, 0) + stateVector(2, 0) * dt;
+    y = stateVector(1, 0) + stateVector(3, 0) * dt;
+}
+
+void TrackFilter::predictPolar(qint64 timeUs, double& radius, double& azimuthDeg) const
+{
+    double x, y;
+    predictPosition(timeUs, x, y);
+    cartesianToPolar(x, y, radius, azimuthDeg);
+}
+
+void TrackFilter::initialize(double radius, double azimuthDeg, double radialSpeed, qint64 timeUs, const Noise& noise)
+{
+    double x, y;
+    polarToCartesian(radius, azimuthDeg, x, y);
+
+    // Only the line-of-sight component of the velocity is known from one detection
+    double azimuth = azimuthDeg * DEG_TO_RAD;
+    double losX = std::sin(azimuth);
+    double losY = std::cos(azimuth);
+
+    stateVector = State();
+    stateVector(0, 0) = x;
+    stateVector(1, 0) = y;
+    stateVector(2, 0) = -radialSpeed * losX;
+    stateVector(3, 0) = -radialSpeed * losY;
+
+    FixedMatrix<2, 2> positionNoise = polarNoise(radius, azimuthDeg, noise);
+    double radialVariance = square(noise.radialSpeedSigma);
+    double tangentialVariance = square(noise.initialSpeedSigma);
+
+    covarianceMatrix = Covariance();
+    covarianceMatrix(0, 0) = positionNoise(0, 0);
+    covarianceMatrix(0, 1) = positionNoise(0, 1);
+    covarianceMatrix(1, 0) = positionNoise(1, 0);
+    covarianceMatrix(1, 1) = positionNoise(1, 1);
+    covarianceMatrix(2, 2) = radialVariance * losX * losX + tangentialVariance * losY * losY;
+    covarianceMatrix(2, 3) = (radialVariance - tangentialVariance) * losX * losY;
+    covarianceMatrix(3, 2) = covarianceMatrix(2, 3);
+    covarianceMatrix(3, 3) = radialVariance * losY * losY + tangentialVariance * losX * losX;
+
+    lastTimeUs = timeUs;
+    initialized = true;
+}
+
+void TrackFilter::predict(double dt, const Noise& noise)
+{
+    Covariance f = Covariance::identity();
+    f(0, 2) = dt;
+    f(1, 3) = dt;
+
+    stateVector = f * stateVector;
+
+    // Piecewise white acceleration noise
+    double q = square(noise.accelerationSigma);
+    double dt2 = dt * dt;
+    double dt3 = dt2 * dt;
+    Covariance processNoise;
+    processNoise(0, 0) = processNoise(1, 1) = q * dt3 * dt / 4.0;
+    processNoise(0, 2) = processNoise(2, 0) = q * dt3 / 2.0;
+    processNoise(1, 3) = processNoise(3, 1) = q * dt3 / 2.0;
+    processNoise(2, 2) = processNoise(3, 3) = q * dt2;
+
+    covarianceMatrix = f * covarianceMatrix * f.transposed() + processNoise;
+}
+
+void TrackFilter::updatePosition(double radius, double azimuthDeg, const Noise& noise)
+{
+    double x, y;
+    polarToCartesian(radius, azimuthDeg, x, y);
+
+    // H = [I 0], so H P and P H^T are slices of P
+    FixedMatrix<2, 4> hp;
+    for (int col = 0; col < 4; ++col) {
+        hp(0, col) = covarianceMatrix(0, col);
+        hp(1, col) = covarianceMatrix(1, col);
+    }
+
+    FixedMatrix<2, 2> s = polarNoise(radius, azimuthDeg, noise);
+    s(0, 0) += hp(0, 0);
+    s(0, 1) += hp(0, 1);
+    s(1, 0) += hp(1, 0);
+    s(1, 1) += hp(1, 1);
+
+    double determinant = s(0, 0) * s(1, 1) - s(0, 1) * s(1, 0);
+    if (std::abs(determinant) < 1e-12) {
+        return;
+    }
+    FixedMatrix<2, 2> sInverse;
+    sInverse(0, 0) = s(1, 1) / determinant;
+    sInverse(0, 1) = -s(0, 1) / determinant;
+    sInverse(1, 0) = -s(1, 0) / determinant;
+    sInverse(1, 1) = s(0, 0) / determinant;
+
+    FixedMatrix<4, 2> gain = hp.transposed() * sInverse;
+
+    FixedMatrix<2, 1> innovation;
+    innovation(0, 0) = x - stateVector(0, 0);
+    innovation(1, 0) = y - stateVector(1, 0);
+
+    stateVector += gain * innovation;
+    covarianceMatrix -= gain * hp;
+    symmetrize(covarianceMatrix);
+}
+
+void TrackFilter::updateRadialSpeed(double radialSpeed, const Noise& noise)
+{
+    double x = stateVector(0, 0);
+    double y = stateVector(1, 0);
+    double vx = stateVector(2, 0);
+    double vy = stateVector(3, 0);
+    double range = std::hypot(x, y);
+    if (range < MIN_RANGE) {
+        return;
+    }
+
+    // h(x) = -(x vx + y vy) / r, positive when approaching; H is its Jacobian
+    double closing = x * vx + y * vy;
+    double predicted = -closing / range;
+    double rangeSquared = range * range;
+
+    FixedMatrix<1, 4> h;
+    h(0, 0) = -(vx - closing * x / rangeSquared) / range;
+    h(0, 1) = -(vy - closing * y / rangeSquared) / range;
+    h(0, 2) = -x / range;
+    h(0, 3) = -y / range;
+
+    FixedMatrix<1, 4> hp = h * covarianceMatrix;
+    double s = square(noise.radialSpeedSigma);
+    for (int col = 0; col < 4; ++col) {
+        s += hp(0, col) * h(0, col);
+    }
+    if (s < 1e-12) {
+        return;
+    }
+
+    FixedMatrix<4, 1> gain = hp.transposed();
+    for (auto& value : gain.values) {
+        value /= s;
+    }
+
+    FixedMatrix<1, 1> innovation;
+    innovation(0, 0) = radialSpeed - predicted;
+
+    stateVector += gain * innovation;
+    covarianceMatrix -= gain * hp;
+    symmetrize(covarianceMatrix);
+}
+
+FixedMatrix<2, 2> TrackFilter::polarNoise(double radius, double azimuthDeg, const Noise& noise)
+{
+    // R = J diag(sr^2, sa^2) J^T with J = d(x, y) / d(r, azimuth)
+    double azimuth = azimuthDeg * DEG_TO_RAD;
+    double sinAz = std::sin(azimuth);
+    double cosAz = std::cos(azimuth);
+    double rangeVariance = square(noise.rangeSigma);
+    double azimuthVariance = square(noise.azimuthSigmaDeg * DEG_TO_RAD) * radius * radius;
+
+    FixedMatrix<2, 2> r;
+    r(0, 0) = rangeVariance * sinAz * sinAz + azimuthVariance * cosAz * cosAz;
+    r(0, 1) = (rangeVariance - azimuthVariance) * sinAz * cosAz;
+    r(1, 0) = r(0, 1);
+    r(1, 1) = rangeVariance * cosAz * cosAz + azimuthVariance * sinAz * sinAz;
+    return r;
+}
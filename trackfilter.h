@@ -0,0 +1,139 @@
+#ifndef TRACKFILTER_H
+#define TRACKFILTER_H
+
+#include <QtGlobal>
+#include <array>
+
+// Fixed-size row-major matrix. Everything lives inline, so filter updates
+// never touch the heap.
+template <int Rows, int Cols>
+struct FixedMatrix {
+    std::array<double, Rows * Cols> values{};
+
+    double& operator()(int row, int col) { return values[row * Cols + col]; }
+    double operator()(int row, int col) const { return values[row * Cols + col]; }
+
+    static FixedMatrix identity()
+    {
+        static_assert(Rows == Cols, "identity of a non-square matrix");
+        FixedMatrix result;
+        for (int i = 0; i < Rows; ++i) {
+            result(i, i) = 1.0;
+        }
+        return result;
+    }
+
+    FixedMatrix<Cols, Rows> transposed() const
+    {
+        FixedMatrix<Cols, Rows> result;
+        for (int row = 0; row < Rows; ++row) {
+            for (int col = 0; col < Cols; ++col) {
+                result(col, row) = (*this)(row, col);
+            }
+        }
+        return result;
+    }
+
+    FixedMatrix& operator+=(const FixedMatrix& other)
+    {
+        for (int i = 0; i < Rows * Cols; ++i) {
+            values[i] += other.values[i];
+        }
+        return *this;
+    }
+
+    FixedMatrix& operator-=(const FixedMatrix& other)
+    {
+        for (int i = 0; i < Rows * Cols; ++i) {
+            values[i] -= other.values[i];
+        }
+        return *this;
+    }
+};
+
+template <int Rows, int Inner, int Cols>
+inline FixedMatrix<Rows, Cols> operator*(const FixedMatrix<Rows, Inner>& a, const FixedMatrix<Inner, Cols>& b)
+{
+    FixedMatrix<Rows, Cols> result;
+    for (int row = 0; row < Rows; ++row) {
+        for (int k = 0; k < Inner; ++k) {
+            double scale = a(row, k);
+            for (int col = 0; col < Cols; ++col) {
+                result(row, col) += scale * b(k, col);
+            }
+        }
+    }
+    return result;
+}
+
+template <int Rows, int Cols>
+inline FixedMatrix<Rows, Cols> operator+(FixedMatrix<Rows, Cols> a, const FixedMatrix<Rows, Cols>& b)
+{
+    return a += b;
+}
+
+template <int Rows, int Cols>
+inline FixedMatrix<Rows, Cols> operator-(FixedMatrix<Rows, Cols> a, const FixedMatrix<Rows, Cols>& b)
+{
+    return a -= b;
+}
+
+// Constant-velocity Kalman filter for one track.
+//
+// The state is Cartesian position and velocity [x, y, vx, vy] in metres and
+// m/s, with y along boresight and x to the right, so azimuth = atan2(x, y).
+// Each detection contributes two measurements:
+//   - position, converted from range/azimuth with the measurement noise
+//     rotated into Cartesian space, and
+//   - radial speed (positive when approaching), which is non-linear in the
+//     state and applied as an extended Kalman update.
+// Times are microseconds on a monotonic clock. A gap longer than
+// RESTART_GAP_US restarts the filter from the next detection.
+class TrackFilter
+{
+public:
+    struct Noise {
+        double accelerationSigma = 3.0;     // m/s^2, process noise of the motion model
+        double rangeSigma = 0.5;            // m
+        double azimuthSigmaDeg = 1.5;       // degrees
+        double radialSpeedSigma = 0.3;      // m/s
+        double initialSpeedSigma = 10.0;    // m/s, velocity uncertainty of a new track
+    };
+
+    using State = FixedMatrix<4, 1>;
+    using Covariance = FixedMatrix<4, 4>;
+
+    static constexpr qint64 RESTART_GAP_US = 3000000;
+
+    TrackFilter() { reset(); }
+
+    void reset();
+    bool isInitialized() const { return initialized; }
+
+    void update(double radius, double azimuthDeg, double radialSpeed, qint64 timeUs, const Noise& noise);
+
+    // Position extrapolated to timeUs, without changing the filter
+    void predictPolar(qint64 timeUs, double& radius, double& azimuthDeg) const;
+    void predictPosition(qint64 timeUs, double& x, double& y) const;
+
+    const State& state() const { return stateVector; }
+    const Covariance& covariance() const { return covarianceMatrix; }
+    qint64 lastUpdateUs() const { return lastTimeUs; }
+
+    static void polarToCartesian(double radius, double azimuthDeg, double& x, double& y);
+    static void cartesianToPolar(double x, double y, double& radius, double& azimuthDeg);
+
+private:
+    State stateVector;
+    Covariance covarianceMatrix;
+    qint64 lastTimeUs;
+    bool initialized;
+
+    void initialize(double radius, double azimuthDeg, double radialSpeed, qint64 timeUs, const Noise& noise);
+    void predict(double dt, const Noise& noise);
+    void updatePosition(double radius, double azimuthDeg, const Noise& noise);
+    void updateRadialSpeed(double radialSpeed, const Noise& noise);
+    static FixedMatrix<2, 2> polarNoise(double radius, double azimuthDeg, const Noise& noise);
+};
+
+#endif // TRACKFILTER_H
@@ -0,0 +1,192 @@
+#include "trackstore.h"
+#include "latencystats.h"
+#include <algorithm>
+
+// TrackStore Implementation
+TrackStore::TrackStore(int expectedTracks)
+    : slotMask(0)
+    , hashShift(32)
+    , filteringEnabled(false)
+{
+    tracks.reserve(static_cast<size_t>(qMax(expectedTracks, 0)));
+    rebuildTable(static_cast<size_t>(qMax(expectedTracks, 0)));
+}
+
+int TrackStore::update(const DetectionData& detection, qint64 nowMs)
+{
+    int index = indexOf(detection.target_id);
+    if (index < 0) {
+        // Grow before the load factor passes 1/2
+        if ((tracks.size() + 1) * 2 > slots.size()) {
+            rebuildTable(tracks.size() + 1);
+        }
+
+        index = static_cast<int>(tracks.size());
+        tracks.emplace_back();
+        Track& track = tracks.back();
+        track.firstSeenMs = nowMs;
+        track.updateCount = 0;
+        track.historyStart = 0;
+        track.historyCount = 0;
+        track.filter.reset();
+        insertSlot(detection.target_id, index);
+    }
+
+    Track& track = tracks[index];
+    track.latest = detection;
+    track.lastSeenMs = nowMs;
+    track.updateCount++;
+
+    TrackPoint point{ detection.radius, detection.azimuth, nowMs };
+    if (filteringEnabled) {
+        qint64 timeUs = detection.receive_time_us > 0 ? detection.receive_time_us : LatencyStats::nowUs();
+        track.filter.update(detection.radius, detection.azimuth, detection.radial_speed, timeUs, filterNoise);
+
+        double radius, azimuth;
+        track.filter.predictPolar(timeUs, radius, azimuth);
+        point.radius = static_cast<float>(radius);
+        point.azimuth = static_cast<float>(azimuth);
+    }
+
+    // Append to the history ring, overwriting the oldest point once full
+    if (track.historyCount < HISTORY_LENGTH) {
+        track.history[(track.historyStart + track.historyCount) & HISTORY_MASK] = point;
+        track.historyCount++;
+    } else {
+        track.history[track.historyStart] = point;
+        track.historyStart = (track.historyStart + 1) & HISTORY_MASK;
+    }
+
+    return index;
+}
+
+int TrackStore::indexOf(quint32 targetId) const
+{
+    for (size_t slot = homeSlot(targetId);; slot = (slot + 1) & slotMask) {
+        const Slot& entry = slots[slot];
+        if (entry.index == EMPTY_SLOT) {
+            return -1;
+        }
+        if (entry.targetId == targetId) {
+            return entry.index;
+        }
+    }
+}
+
+const TrackStore::Track* TrackStore::find(quint32 targetId) const
+{
+    int index = indexOf(targetId);
+    return index >= 0 ? &tracks[index] : nullptr;
+}
+
+int TrackStore::expire(qint64 cutoffMs)
+{
+    return removeIf([cutoffMs](const Track& track) { return track.lastSeenMs < cutoffMs; });
+}
+
+qint64 TrackStore::oldestLastSeen() const
+{
+    if (tracks.empty()) {
+        return 0;
+    }
+    qint64 oldest = tracks.front().lastSeenMs;
+    for (const auto& track : tracks) {
+        oldest = qMin(oldest, track.lastSeenMs);
+    }
+    return oldest;
+}
+
+int TrackStore::trimTo(int maxTracks)
+{
+    maxTracks = qMax(maxTracks, 0);
+    if (size() <= maxTracks) {
+        return 0;
+    }
+
+    // The excess-th oldest last-seen time splits the tracks to drop from those to keep
+    int excess = size() - maxTracks;
+    std::vector<qint64> lastSeen;
+    lastSeen.reserve(tracks.size());
+    for (const auto& track : tracks) {
+        lastSeen.push_back(track.lastSeenMs);
+    }
+    std::nth_element(lastSeen.begin(), lastSeen.begin() + (excess - 1), lastSeen.end());
+    qint64 cutoff = lastSeen[excess - 1];
+
+    int olderCount = static_cast<int>(std::count_if(lastSeen.begin(), lastSeen.end(),
+                                                    [cutoff](qint64 seen) { return seen < cutoff; }));
+    int tiesToDrop = excess - olderCount;
+    return removeIf([cutoff, &tiesToDrop](const Track& track) {
+        if (track.lastSeenMs < cutoff) {
+            return true;
+        }
+        if (track.lastSeenMs == cutoff && tiesToDrop > 0) {
+            tiesToDrop--;
+            return true;
+        }
+        return false;
+    });
+}
+
+void TrackStore::removeRange(int first, int count)
+{
+    if (first < 0 || count <= 0 || first >= size()) {
+        return;
+    }
+    count = qMin(count, size() - first);
+    tracks.erase(tracks.begin() + first, tracks.begin() + first + count);
+    rebuildTable(tracks.size());
+}
+
+void TrackStore::clear()
+{
+    tracks.clear();
+    rebuildTable(0);
+}
+
+void TrackStore::setFilteringEnabled(bool enabled)
+{
+    if (enabled == filteringEnabled) {
+        return;
+    }
+    filteringEnabled = enabled;
+
+    // Filters restart from the next detection rather than from stale state
+    for (auto& track : tracks) {
+        track.filter.reset();
+    }
+}
+
+void TrackStore::insertSlot(quint32 targetId, qint32 index)
+{
+    size_t slot = homeSlot(targetId);
+    while (slots[slot].index != EMPTY_SLOT) {
+        slot = (slot + 1) & slotMask;
+    }
+    slots[slot].targetId = targetId;
+    slots[slot].index = index;
+}
+
+void TrackStore::rebuildTable(size_t minimumTracks)
+{
+    size_t wanted = MIN_TABLE_SIZE;
+    int bits = 4;
+    while (wanted < minimumTracks * 2) {
+        wanted <<= 1;
+        bits++;
+    }
+
+    // Keep a larger table after removals unless it has become mostly empty
+    if (wanted < slots.size() && slots.size() <= wanted * 4) {
+        wanted = slots.size();
+        bits = 32 - hashShift;
+    }
+
+    slots.assign(wanted, Slot{ 0, EMPTY_SLOT });
+    slotMask = static_cast<quint32>(wanted - 1);
+    hashShift = 32 - bits;
+
+    for (size_t i = 0; i < tracks.size(); ++i) {
+        insertSlot(tracks[i].latest.target_id, static_cast<qint32>(i));
+    }
+}
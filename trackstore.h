@@ -0,0 +1,164 @@
+#ifndef TRACKSTORE_H
+#define TRACKSTORE_H
+
+#include <QtGlobal>
+#include <array>
+#include <utility>
+#include <vector>
+#include "structures.h"
+#include "trackfilter.h"
+
+// Live tracks keyed by target_id.
+//
+// Tracks live in a dense array in the order they first appeared, so walking
+// the current tracks costs O(tracks) however many detections each of them
+// has received. An open-addressing hash table (linear probing, power-of-two
+// size, load factor at most 1/2) maps target_id to the track's index, which
+// makes lookup and update O(1). Removing tracks keeps the survivors in order
+// and rebuilds the table, so an index stays valid until the next removal.
+//
+// Each track holds its latest detection and a ring of the last
+// HISTORY_LENGTH positions, oldest first. With filtering enabled every
+// track also runs a TrackFilter, and the history records the smoothed
+// positions instead of the raw measurements. Not thread-safe.
+class TrackStore
+{
+public:
+    static constexpr int HISTORY_LENGTH = 32;
+
+    struct TrackPoint {
+        float radius;
+        float azimuth;
+        qint64 timeMs;
+    };
+
+    struct Track {
+        DetectionData latest;
+        qint64 firstSeenMs;
+        qint64 lastSeenMs;
+        quint32 updateCount;
+        TrackFilter filter;   // only updated while filtering is enabled
+
+        int historySize() const { return historyCount; }
+        const TrackPoint& historyAt(int i) const { return history[(historyStart + i) & HISTORY_MASK]; }
+
+    private:
+        friend class TrackStore;
+        std::array<TrackPoint, HISTORY_LENGTH> history;
+        int historyStart;
+        int historyCount;
+    };
+
+    explicit TrackStore(int expectedTracks = 64);
+
+    // Inserts or updates the track of detection.target_id and returns its index
+    int update(const DetectionData& detection, qint64 nowMs);
+
+    template <typename Container>
+    void updateBatch(const Container& detections, qint64 nowMs)
+    {
+        for (const auto& detection : detections) {
+            update(detection, nowMs);
+        }
+    }
+
+    int indexOf(quint32 targetId) const;   // -1 if there is no such track
+    const Track* find(quint32 targetId) const;
+
+    const Track& at(int index) const { return tracks[index]; }
+    int size() const { return static_cast<int>(tracks.size()); }
+    bool isEmpty() const { return tracks.empty(); }
+
+    std::vector<Track>::const_iterator begin() const { return tracks.begin(); }
+    std::vector<Track>::const_iterator end() const { return tracks.end(); }
+
+    // Removes tracks last seen before cutoffMs; returns how many were removed
+    int expire(qint64 cutoffMs);
+
+    // Earliest lastSeenMs of any track, so callers know when the next one
+    // expires; 0 when empty
+    qint64 oldestLastSeen() const;
+
+    // Removes the least recently seen tracks until at most maxTracks remain
+    int trimTo(int maxTracks);
+
+    // Removes count tracks starting at index first
+    void removeRange(int first, int count);
+
+    // Removes each [first, last] range in ranges, which must be ascending and
+    // disjoint. aboutToRemove(first, last) and removed() bracket every range,
+    // last range first, so a model can report each one; the ID table is only
+    // rebuilt at the end, so indexOf() must not be called from them.
+    template <typename AboutToRemove, typename Removed>
+    void removeRanges(const std::vector<std::pair<int, int>>& ranges, AboutToRemove aboutToRemove, Removed removed)
+    {
+        if (ranges.empty()) {
+            return;
+        }
+        for (auto range = ranges.rbegin(); range != ranges.rend(); ++range) {
+            aboutToRemove(range->first, range->second);
+            tracks.erase(tracks.begin() + range->first, tracks.begin() + range->second + 1);
+            removed();
+        }
+        rebuildTable(tracks.size());
+    }
+
+    void clear();
+
+    // Smoothing. The filter runs on DetectionData::receive_time_us, or the
+    // LatencyStats clock for detections without one.
+    void setFilteringEnabled(bool enabled);
+    bool isFilteringEnabled() const { return filteringEnabled; }
+    void setFilterNoise(const TrackFilter::Noise& noise) { filterNoise = noise; }
+
+private:
+    static constexpr int HISTORY_MASK = HISTORY_LENGTH - 1;
+    static_assert((HISTORY_LENGTH & HISTORY_MASK) == 0, "HISTORY_LENGTH must be a power of two");
+
+    static constexpr qint32 EMPTY_SLOT = -1;
+    static constexpr int MIN_TABLE_SIZE = 16;
+
+    struct Slot {
+        quint32 targetId;
+        qint32 index;
+    };
+
+    std::vector<Track> tracks;
+    std::vector<Slot> slots;
+    quint32 slotMask;
+    int hashShift;
+    bool filteringEnabled;
+    TrackFilter::Noise filterNoise;
+
+    size_t homeSlot(quint32 targetId) const
+    {
+        // Fibonacci hashing spreads sequential IDs across the table
+        return static_cast<size_t>((targetId * 2654435769u) >> hashShift);
+    }
+
+    void insertSlot(quint32 targetId, qint32 index);
+    void rebuildTable(size_t minimumTracks);
+
+    // Keeps the order of the remaining tracks
+    template <typename Predicate>
+    int removeIf(Predicate pred)
+    {
+        size_t kept = 0;
+        for (size_t i = 0; i < tracks.size(); ++i) {
+            if (!pred(tracks[i])) {
+                if (kept != i) {
+                    tracks[kept] = tracks[i];
+                }
+                ++kept;
+            }
+        }
+        int removed = static_cast<int>(tracks.size() - kept);
+        if (removed > 0) {
+            tracks.resize(kept);
+            rebuildTable(kept);
+        }
+        return removed;
+    }
+};
+
+#endif // TRACKSTORE_H
@@ -0,0 +1,285 @@
+#include "tracktablemodel.h"
+#include <QGuiApplication>
+#include <QScreen>
+#include <QColor>
+#include <QBrush>
+#include <QDateTime>
+#include <algorithm>
+#include <limits>
+
+TrackTableModel::TrackTableModel(QObject* parent)
+    : QAbstractTableModel(parent)
+    , pendingReceiveTime(0)
+    , trackTimeoutMs(DEFAULT_TRACK_TIMEOUT_MS)
+    , nextExpiryMs(std::numeric_limits<qint64>::max())
+{
+    // Apply staged updates at most once per display refresh
+    refreshTimer = new QTimer(this);
+    refreshTimer->setTimerType(Qt::PreciseTimer);
+    connect(refreshTimer, &QTimer::timeout, this, &TrackTableModel::flushPendingUpdates);
+
+    double refreshRate = 60.0;
+    if (QScreen* screen = QGuiApplication::primaryScreen()) {
+        if (screen->refreshRate() > 1.0) {
+            refreshRate = screen->refreshRate();
+        }
+    }
+    refreshTimer->setInterval(qMax(1, static_cast<int>(1000.0 / refreshRate)));
+
+    expiryTimer = new QTimer(this);
+    expiryTimer->setSingleShot(true);
+    expiryTimer->setTimerType(Qt::PreciseTimer);
+    connect(expiryTimer, &QTimer::timeout, this, &TrackTableModel::flushPendingUpdates);
+}
+
+int TrackTableModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : tracks.size();
+}
+
+int TrackTableModel::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant TrackTableModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= tracks.size()) {
+        return QVariant();
+    }
+
+    const DetectionData& detection = tracks.at(index.row()).latest;
+
+    switch (role) {
+    case Qt::DisplayRole:
+        switch (index.column()) {
+        case TrackIdColumn: return QString::number(detection.target_id);
+        case RadiusColumn:  return QString::number(detection.radius, 'f', 1);
+        case SpeedColumn:   return QString::number(detection.radial_speed, 'f', 2);
+        case AzimuthColumn: return QString::number(detection.azimuth, 'f', 1);
+        default:            break;
+        }
+        break;
+
+    case SortRole:
+        switch (index.column()) {
+        case TrackIdColumn: return detection.target_id;
+        case RadiusColumn:  return detection.radius;
+        case SpeedColumn:   return detection.radial_speed;
+        case AzimuthColumn: return detection.azimuth;
+        default:            break;
+        }
+        break;
+
+    case Qt::TextAlignmentRole:
+        return static_cast<int>(Qt::AlignCenter);
+
+    case Qt::BackgroundRole:
+        // Color code based on speed
+        if (index.column() == SpeedColumn) {
+            if (detection.radial_speed > 2.0) {
+                return QBrush(QColor(255, 200, 200)); // Light red for approaching
+            } else if (detection.radial_speed < -2.0) {
+                return QBrush(QColor(200, 255, 200)); // Light green for receding
+            } else {
+                return QBrush(QColor(255, 255, 200)); // Light yellow for stationary
+            }
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    return QVariant();
+}
+
+QVariant TrackTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+
+    switch (section) {
+    case TrackIdColumn: return QString("Track ID");
+    case RadiusColumn:  return QString("Radius (m)");
+    case SpeedColumn:   return QString("Radial Speed (m/s)");
+    case AzimuthColumn: return QString("Azimuth (°)");
+    default:            return QVariant();
+    }
+}
+
+void TrackTableModel::updateDetections(const QVector<DetectionData>& detections)
+{
+    // Only the latest detection per track matters until the next flush
+    for (const auto& detection : detections) {
+        pendingUpdates.insert(detection.target_id, detection);
+    }
+    pendingReceiveTime = QDateTime::currentMSecsSinceEpoch();
+
+    scheduleFlush();
+}
+
+void TrackTableModel::clear()
+{
+    beginResetModel();
+    tracks.clear();
+    pendingUpdates.clear();
+    endResetModel();
+    refreshTimer->stop();
+    expiryTimer->stop();
+    nextExpiryMs = std::numeric_limits<qint64>::max();
+}
+
+bool TrackTableModel::trackAt(int row, DetectionData& detection) const
+{
+    if (row < 0 || row >= tracks.size()) {
+        return false;
+    }
+    detection = tracks.at(row).latest;
+    return true;
+}
+
+void TrackTableModel::setRefreshInterval(int intervalMs)
+{
+    refreshTimer->setInterval(qMax(1, intervalMs));
+}
+
+void TrackTableModel::setTrackTimeout(int timeoutMs)
+{
+    trackTimeoutMs = timeoutMs;
+    scheduleExpiry(QDateTime::currentMSecsSinceEpoch());
+}
+
+void TrackTableModel::setRenderScheduler(RenderScheduler* scheduler)
+{
+    if (renderScheduler) {
+        disconnect(renderScheduler, &RenderScheduler::frameTick, this, &TrackTableModel::flushPendingUpdates);
+    }
+    renderScheduler = scheduler;
+
+    // Flush on the scheduler's frames instead of the model's own timer
+    refreshTimer->stop();
+    if (renderScheduler) {
+        connect(renderScheduler, &RenderScheduler::frameTick, this, &TrackTableModel::flushPendingUpdates);
+    }
+    if (!pendingUpdates.isEmpty()) {
+        scheduleFlush();
+    }
+}
+
+void TrackTableModel::scheduleFlush()
+{
+    if (renderScheduler) {
+        renderScheduler->requestFrame();
+    } else if (!refreshTimer->isActive()) {
+        refreshTimer->start();
+    }
+}
+
+void TrackTableModel::flushPendingUpdates()
+{
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+    // Frames requested by other widgets, or an early wakeup: nothing to do yet
+    if (pendingUpdates.isEmpty() && now < nextExpiryMs) {
+        if (!expiryTimer->isActive() && nextExpiryMs != std::numeric_limits<qint64>::max()) {
+            expiryTimer->start(static_cast<int>(qMin<qint64>(nextExpiryMs - now, std::numeric_limits<int>::max())));
+        }
+        return;
+    }
+
+    applyPendingUpdates();
+    removeExpiredTracks(now);
+
+    // The next datagram restarts the refresh; until then only expiry can change rows
+    refreshTimer->stop();
+    scheduleExpiry(now);
+}
+
+void TrackTableModel::scheduleExpiry(qint64 now)
+{
+    if (tracks.isEmpty()) {
+        nextExpiryMs = std::numeric_limits<qint64>::max();
+        expiryTimer->stop();
+        return;
+    }
+
+    // A track expires once it is strictly older than the timeout
+    nextExpiryMs = tracks.oldestLastSeen() + trackTimeoutMs + 1;
+    expiryTimer->start(static_cast<int>(qBound<qint64>(0, nextExpiryMs - now, std::numeric_limits<int>::max())));
+}
+
+void TrackTableModel::applyPendingUpdates()
+{
+    if (pendingUpdates.isEmpty()) {
+        return;
+    }
+
+    QVector<int> changedRows;
+    QVector<DetectionData> newTracks;
+    changedRows.reserve(pendingUpdates.size());
+
+    // Known tracks update in place; new ones are appended inside one insert
+    for (auto it = pendingUpdates.constBegin(); it != pendingUpdates.constEnd(); ++it) {
+        if (tracks.indexOf(it.key()) >= 0) {
+            changedRows.append(tracks.update(it.value(), pendingReceiveTime));
+        } else {
+            newTracks.append(it.value());
+        }
+    }
+    pendingUpdates.clear();
+
+    emitChangedRows(changedRows);
+
+    if (!newTracks.isEmpty()) {
+        int first = tracks.size();
+        beginInsertRows(QModelIndex(), first, first + newTracks.size() - 1);
+        tracks.updateBatch(newTracks, pendingReceiveTime);
+        endInsertRows();
+    }
+}
+
+void TrackTableModel::emitChangedRows(QVector<int>& changedRows)
+{
+    if (changedRows.isEmpty()) {
+        return;
+    }
+
+    // One dataChanged per contiguous run of rows
+    std::sort(changedRows.begin(), changedRows.end());
+    int runStart = changedRows.first();
+    int runEnd = runStart;
+    for (int i = 1; i <= changedRows.size(); ++i) {
+        if (i < changedRows.size() && changedRows[i] == runEnd + 1) {
+            runEnd = changedRows[i];
+            continue;
+        }
+        emit dataChanged(index(runStart, 0), index(runEnd, ColumnCount - 1));
+        if (i < changedRows.size()) {
+            runStart = runEnd = changedRows[i];
+        }
+    }
+}
+
+void TrackTableModel::removeExpiredTracks(qint64 now)
+{
+    qint64 cutoff = now - trackTimeoutMs;
+
+    std::vector<std::pair<int, int>> runs;
+    for (int row = 0; row < tracks.size(); ++row) {
+        if (tracks.at(row).lastSeenMs >= cutoff) {
+            continue;
+        }
+        if (!runs.empty() && runs.back().second == row - 1) {
+            runs.back().second = row;
+        } else {
+            runs.emplace_back(row, row);
+        }
+    }
+
+    // One removal per contiguous run of rows, one rebuild of the ID table
+    tracks.removeRanges(runs,
+                        [this](int first, int last) { beginRemoveRows(QModelIndex(), first, last); },
+                        [this]() { endRemoveRows(); });
+}
@@ -0,0 +1,78 @@
+#ifndef TRACKTABLEMODEL_H
+#define TRACKTABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QHash>
+#include <QTimer>
+#include <QPointer>
+#include <QVector>
+#include "structures.h"
+#include "trackstore.h"
+#include "renderscheduler.h"
+
+// Table model with one row per track_id. Incoming detections are staged and
+// applied at most once per display refresh; only rows that actually changed
+// are reported through dataChanged/rowsInserted/rowsRemoved, so the view never
+// rebuilds and stays responsive with thousands of live tracks. Rows are the
+// tracks of a TrackStore in the order they first appeared. With a
+// RenderScheduler the flushes run on its frames instead of a private timer.
+// Between datagrams the model sleeps until the oldest track is due to expire,
+// so an idle stream requests no frames.
+class TrackTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        TrackIdColumn,
+        RadiusColumn,
+        SpeedColumn,
+        AzimuthColumn,
+        ColumnCount
+    };
+
+    // Role carrying the raw numeric value, used for sorting
+    static constexpr int SortRole = Qt::UserRole;
+
+    explicit TrackTableModel(QObject* parent = nullptr);
+
+    // QAbstractTableModel interface
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    // Data management
+    void updateDetections(const QVector<DetectionData>& detections);
+    void clear();
+    bool trackAt(int row, DetectionData& detection) const;
+
+    // Configuration
+    void setRefreshInterval(int intervalMs);
+    void setTrackTimeout(int timeoutMs);
+    void setRenderScheduler(RenderScheduler* scheduler);
+
+public slots:
+    void flushPendingUpdates();
+
+private:
+    TrackStore tracks;   // lastSeenMs is the local receive time, used for expiry
+    QHash<uint32_t, DetectionData> pendingUpdates;   // latest detection per track since last flush
+    qint64 pendingReceiveTime;
+
+    QTimer* refreshTimer;
+    QTimer* expiryTimer;   // wakes the model when the oldest track times out
+    QPointer<RenderScheduler> renderScheduler;
+    int trackTimeoutMs;
+    qint64 nextExpiryMs;
+
+    void scheduleFlush();
+    void scheduleExpiry(qint64 now);
+    void applyPendingUpdates();
+    void removeExpiredTracks(qint64 now);
+    void emitChangedRows(QVector<int>& changedRows);
+
+    static constexpr int DEFAULT_TRACK_TIMEOUT_MS = 10000;
+};
+
+#endif // TRACKTABLEMODEL_H
@@ -1,4 +1,8 @@
 #include "udphandler.h"
+#include "detectionparser.h"
+#include "capturerecorder.h"
+#include "latencystats.h"
+#include "radarlog.h"
 #include <QNetworkDatagram>
 #include <QHostAddress>
 #include <algorithm>
@@ -8,15 +12,24 @@ UdpHandler::UdpHandler(QObject *parent)
     , udpSocket(nullptr)
     , currentPort(0)
     , connected(false)
+    , ingestMode(WorkerThreadIngest)
+    , captureRecorder(nullptr)
+    , latencyStats(nullptr)
+    , idAssociation(false)
     , remoteHost("127.0.0.1")
     , remotePort(5001)
+    , detections(1000)
     , maxDetections(1000)
     , detectionTimeoutMs(60000) // 60 seconds
     , packetsReceived(0)
     , packetsDropped(0)
+    , detectionsDropped(0)
     , lastStatisticsUpdate(0)
     , lastPacketTime(0)
 {
+    qRegisterMetaType<DetectionData>("DetectionData");
+    qRegisterMetaType<QVector<DetectionData>>("QVector<DetectionData>");
+
     // Setup cleanup timer to remove old detections
     cleanupTimer = new QTimer(this);
     connect(cleanupTimer, &QTimer::timeout, this, &UdpHandler::cleanupOldDetections);
@@ -40,32 +53,47 @@ bool UdpHandler::connectToHost(const QString& host, int port)
     // Disconnect existing connection
     disconnectFromHost();
 
-    // Create new UDP socket
-    udpSocket = std::make_unique<QUdpSocket>(this);
-
     // Try to bind to the specified port
     QHostAddress bindAddress = QHostAddress::Any;
     if (host != "0.0.0.0" && host != "127.0.0.1") {
         bindAddress = QHostAddress(host);
     }
 
-    if (!udpSocket->bind(bindAddress, port)) {
-        QString error = QString("Failed to bind to %1:%2 - %3")
-                        .arg(host)
-                        .arg(port)
-                        .arg(udpSocket->errorString());
-        emit errorOccurred(error);
-        udpSocket.reset();
-        return false;
-    }
+    if (ingestMode == WorkerThreadIngest) {
+        QString bindError;
+        if (!startReceiverThread(bindAddress, port, &bindError)) {
+            emit errorOccurred(QString("Failed to bind to %1:%2 - %3")
+                               .arg(host)
+                               .arg(port)
+                               .arg(bindError));
+            return false;
+        }
+    } else {
+        // Create new UDP socket
+        udpSocket = std::make_unique<QUdpSocket>(this);
+
+        if (!udpSocket->bind(bindAddress, port)) {
+            QString error = QString("Failed to bind to %1:%2 - %3")
+                            .arg(host)
+                            .arg(port)
+                            .arg(udpSocket->errorString());
+            emit errorOccurred(error);
+            udpSocket.reset();
+            return false;
+        }
 
-    // Connect signals
-    connect(udpSocket.get(), &QUdpSocket::readyRead, this, &UdpHandler::readPendingDatagrams);
-    connect(udpSocket.get(), QOverload<QAbstractSocket::SocketError>::of(&QAbstractSocket::error),
-            [this](QAbstractSocket::SocketError error) {
-                Q_UNUSED(error);
-                emit errorOccurred(QString("UDP Socket Error: %1").arg(udpSocket->errorString()));
-            });
+        // Connect signals
+        connect(udpSocket.get(), &QUdpSocket::readyRead, this, &UdpHandler::readPendingDatagrams);
+#if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
+        connect(udpSocket.get(), &QAbstractSocket::errorOccurred,
+#else
+        connect(udpSocket.get(), QOverload<QAbstractSocket::SocketError>::of(&QAbstractSocket::error),
+#endif
+                [this](QAbstractSocket::SocketError error) {
+                    Q_UNUSED(error);
+                    emit errorOccurred(QString("UDP Socket Error: %1").arg(udpSocket->errorString()));
+                });
+    }
 
     // Store connection info
     currentHost = host;
@@ -75,7 +103,7 @@ bool UdpHandler::connectToHost(const QString& host, int port)
     // Reset statistics
     resetStatistics();
 
-    //qDebug() << "UDP Handler connected to" << host << ":" << port;
+    RADAR_LOG_INFO("UDP handler listening on {}:{}", host, port);
     emit connectionStatusChanged(true);
 
     return true;
@@ -83,6 +111,8 @@ bool UdpHandler::connectToHost(const QString& host, int port)
 
 void UdpHandler::disconnectFromHost()
 {
+    stopReceiverThread();
+
     if (udpSocket) {
         udpSocket->close();
         udpSocket.reset();
@@ -97,19 +127,91 @@ void UdpHandler::disconnectFromHost()
 
 bool UdpHandler::isConnected() const
 {
-    return connected && udpSocket && udpSocket->state() == QAbstractSocket::BoundState;
+    if (!connected) {
+        return false;
+    }
+    if (receiver) {
+        return true;
+    }
+    return udpSocket && udpSocket->state() == QAbstractSocket::BoundState;
+}
+
+bool UdpHandler::startReceiverThread(const QHostAddress& bindAddress, int port, QString* error)
+{
+    detectionQueue.clear();
+
+    receiverThread = std::make_unique<QThread>();
+    receiverThread->setObjectName("UdpReceiver");
+    receiver = std::make_unique<UdpReceiver>(&detectionQueue);
+    receiver->setCaptureRecorder(captureRecorder);
+    receiver->setLatencyStats(latencyStats);
+    receiver->setIdAssociation(idAssociation);
+    receiver->moveToThread(receiverThread.get());
+
+    connect(receiver.get(), &UdpReceiver::detectionsReady, this, &UdpHandler::processQueuedDetections);
+    connect(receiver.get(), &UdpReceiver::errorOccurred, this, &UdpHandler::errorOccurred);
+
+    receiverThread->start(QThread::HighPriority);
+
+    // Socket and notifier must be created on the receive thread
+    bool opened = false;
+    UdpReceiver* worker = receiver.get();
+    QMetaObject::invokeMethod(worker, [worker, bindAddress, port, error, &opened]() {
+        opened = worker->open(bindAddress, static_cast<quint16>(port), error);
+    }, Qt::BlockingQueuedConnection);
+
+    if (!opened) {
+        stopReceiverThread();
+        return false;
+    }
+
+    return true;
+}
+
+void UdpHandler::stopReceiverThread()
+{
+    if (!receiverThread) {
+        return;
+    }
+
+    UdpReceiver* worker = receiver.get();
+    QMetaObject::invokeMethod(worker, [worker]() {
+        worker->close();
+    }, Qt::BlockingQueuedConnection);
+
+    receiverThread->quit();
+    receiverThread->wait();
+
+    // The thread has finished, so the receiver can be destroyed from here
+    receiver.reset();
+    receiverThread.reset();
+    detectionQueue.clear();
+}
+
+void UdpHandler::setMaxDetections(int max)
+{
+    maxDetections = max;
+    // Growing the store reallocates it. Both of its sides run on this thread:
+    // the receive thread only fills detectionQueue, which is drained here.
+    detections.setWindow(static_cast<size_t>(qMax(1, max)));
 }
 
 std::vector<DetectionData> UdpHandler::getRecentDetections() const
 {
-    QMutexLocker locker(&detectionsMutex);
-    return detections;
+    std::vector<DetectionData> snapshot;
+    detections.copyTo(snapshot);
+    return snapshot;
 }
 
 int UdpHandler::getDetectionCount() const
 {
-    QMutexLocker locker(&detectionsMutex);
-    return detections.size();
+    return static_cast<int>(detections.size());
+}
+
+void UdpHandler::clearDetections()
+{
+    detections.clear();
+    outgoingBatch.clear();
 }
 
 double UdpHandler::getDataRate() const
@@ -134,225 +236,178 @@ void UdpHandler::readPendingDatagrams()
         QNetworkDatagram datagram = udpSocket->receiveDatagram();
 
         if (datagram.isValid()) {
+            qint64 receiveTimeUs = LatencyStats::nowUs();
             QByteArray data = datagram.data();
-
-            if (parseDetectionData(data)) {
-                //qDebug()<<packetsReceived<<"\n";
-                packetsReceived++;
-                lastPacketTime = QDateTime::currentMSecsSinceEpoch();
-            } else {
-                packetsDropped++;
-                //qDebug() << "Failed to parse UDP packet from" << datagram.senderAddress().toString();
+            if (captureRecorder) {
+                captureRecorder->append(data.constData(), data.size(), CaptureFile::nowUs());
             }
+            ingestDatagram(data.constData(), data.size(), receiveTimeUs);
         }
     }
 
-    emit detectionsUpdated();
+    flushIngestedDetections();
 }
 
-bool UdpHandler::parseDetectionData(const QString& data)
+bool UdpHandler::ingestDatagram(const char* data, int size, qint64 receiveTimeUs)
 {
-    if (data.isEmpty()) {
+    if (receiveTimeUs == 0) {
+        receiveTimeUs = LatencyStats::nowUs();
+    }
+
+    pendingDetections.clear();
+    if (!parseDetectionData(QByteArray::fromRawData(data, size), pendingDetections)) {
+        packetsDropped++;
+        RADAR_LOG_DEBUG("Failed to parse UDP datagram of {} bytes", size);
         return false;
     }
 
-//    try {
-//        // Try to parse as JSON first
-//        QJsonParseError error;
-//        QJsonDocument doc = QJsonDocument::fromJson(data, &error);
-
-//        if (error.error == QJsonParseError::NoError && doc.isObject()) {
-//            return parseJsonData(doc);
-//        }
-
-//        // Try to parse as CSV
-//        QString csvData = QString::fromUtf8(data).trimmed();
-//        if (!csvData.isEmpty()) {
-//            return parseCsvData(csvData);
-//        }
-
-//    } catch (const std::exception& e) {
-//        //qDebug() << "Exception parsing detection data:" << e.what();
-//    } catch (...) {
-//        //qDebug() << "Unknown exception parsing detection data";
-//    }
-
-//    return false;
-
-    QStringList lines = data.split("\n", QString::SkipEmptyParts);
-
-    //QVector<DetectionData> targets;
-    DetectionData targets;
-    //qDebug()<<"lines "<<lines;
-    for (const QString &line : lines) {
-        //if (!line.contains("NumTargets:")) continue;
-
-        QStringList parts = line.split(" ", QString::SkipEmptyParts);
-        //qDebug()<<"parts "<<parts.size();
-        TargetDetection target;
-        for (int i = 0; i < parts.size(); ++i) {
-            if (parts[i] == "TgtId:" && i + 1 < parts.size())
-                targets.target_id = parts[i + 1].toInt();
-            if (parts[i] == "Range:" && i + 1 < parts.size())
-                targets.radius = parts[i + 1].toFloat();
-            if (parts[i] == "Speed:" && i + 1 < parts.size())
-                targets.radial_speed = parts[i + 1].toFloat();
-            if (parts[i] == "azimuth:" && i + 1 < parts.size())
-                targets.azimuth = parts[i + 1].toFloat();
-            if (parts[i] == "amplitude:" && i + 1 < parts.size())
-                targets.amplitude = parts[i + 1].toFloat();
-            if (parts[i] == "timestamp:" && i + 1 < parts.size())
-                targets.timestamp = parts[i + 1].toInt();
-        }
-       // targets.append(target);
-        addDetection(targets);
+    packetsReceived++;
+    lastPacketTime = QDateTime::currentMSecsSinceEpoch();
+    for (auto& detection : pendingDetections) {
+        detection.receive_time_us = receiveTimeUs;
+    }
+    if (idAssociation) {
+        associator.associate(pendingDetections.data(), pendingDetections.size(), receiveTimeUs);
     }
+    if (latencyStats) {
+        latencyStats->record(LatencyStats::ParseStage, receiveTimeUs, LatencyStats::nowUs(),
+                             pendingDetections.size());
+    }
+
+    for (const auto& detection : pendingDetections) {
+        addDetection(detection);
+    }
+    recordStoreLatency();
     return true;
 }
 
-bool UdpHandler::parseJsonData(const QJsonDocument& doc)
+void UdpHandler::flushIngestedDetections()
 {
-    QJsonObject obj = doc.object();
-    bool parsedAny = false;
-
-    // Handle single detection
-    if (obj.contains("target_id") && obj.contains("radius") &&
-        obj.contains("radial_speed") && obj.contains("azimuth") &&
-        obj.contains("amplitude") && obj.contains("timestamp")) {
-
-        DetectionData detection;
-        detection.target_id = obj["target_id"].toInt();
-        detection.radius = obj["radius"].toDouble();
-        detection.radial_speed = obj["radial_speed"].toDouble();
-        detection.azimuth = obj["azimuth"].toDouble();
-        QJsonValue amplitudeValue = obj.value("amplitude");
-        detection.amplitude = amplitudeValue.isUndefined() ? 0.0 : amplitudeValue.toDouble();
-        detection.timestamp = QDateTime::currentMSecsSinceEpoch();
-
-        if (isValidDetection(detection)) {
-            addDetection(detection);
-            parsedAny = true;
-        }
-    }
-    // Handle array of detections
-    else if (obj.contains("detections") && obj["detections"].isArray()) {
-        QJsonArray detArray = obj["detections"].toArray();
-        for (const auto& detValue : detArray) {
-            if (detValue.isObject()) {
-                QJsonObject detObj = detValue.toObject();
-                DetectionData detection;
-                detection.target_id = detObj["target_id"].toInt();
-                detection.radius = detObj["radius"].toDouble();
-                detection.radial_speed = detObj["radial_speed"].toDouble();
-                detection.azimuth = detObj["azimuth"].toDouble();
-                //QJsonValue amplitudeValue = detObj.value("amplitude");
-                //detection.amplitude = amplitudeValue.isUndefined() ? 0.0 : amplitudeValue.toDouble();
-                //detection.timestamp = QDateTime::currentMSecsSinceEpoch();
-
-                if (isValidDetection(detection)) {
-                    addDetection(detection);
-                    parsedAny = true;
-                }
-            }
-        }
-    }
+    emitDetectionBatch();
+    emit detectionsUpdated();
+}
 
-    return parsedAny;
+void UdpHandler::setCaptureRecorder(CaptureRecorder* recorder)
+{
+    captureRecorder = recorder;
+
+    // Swap on the receive thread so no append is in flight once this returns
+    if (receiver) {
+        UdpReceiver* worker = receiver.get();
+        QMetaObject::invokeMethod(worker, [worker, recorder]() {
+            worker->setCaptureRecorder(recorder);
+        }, Qt::BlockingQueuedConnection);
+    }
 }
 
-bool UdpHandler::parseCsvData(const QString& csvData)
+void UdpHandler::setLatencyStats(LatencyStats* stats)
 {
-    QStringList lines = csvData.split('\n');
-    bool parsedAny = false;
+    latencyStats = stats;
 
-    for (const QString& line : lines) {
-        QString trimmedLine = line.trimmed();
-        if (trimmedLine.isEmpty()) continue;
+    if (receiver) {
+        UdpReceiver* worker = receiver.get();
+        QMetaObject::invokeMethod(worker, [worker, stats]() {
+            worker->setLatencyStats(stats);
+        }, Qt::BlockingQueuedConnection);
+    }
+}
 
-        QStringList parts = trimmedLine.split(',');
-        if (parts.size() >= 4) {
-            DetectionData detection;
-            bool ok = true;
+void UdpHandler::setIdAssociation(bool enabled)
+{
+    idAssociation = enabled;
+    associator.reset();
+
+    if (receiver) {
+        UdpReceiver* worker = receiver.get();
+        QMetaObject::invokeMethod(worker, [worker, enabled]() {
+            worker->setIdAssociation(enabled);
+        }, Qt::BlockingQueuedConnection);
+    }
+}
 
-            detection.target_id = parts[0].toInt(&ok);
-            if (!ok) continue;
+void UdpHandler::recordStoreLatency()
+{
+    if (latencyStats) {
+        latencyStats->recordBatch(LatencyStats::StoreStage, pendingDetections, LatencyStats::nowUs());
+    }
+}
 
-            detection.radius = parts[1].toDouble(&ok);
-            if (!ok) continue;
+void UdpHandler::processQueuedDetections()
+{
+    int packets = 0;
+    int dropped = 0;
+    int overflowed = 0;
+    detectionQueue.drain(pendingDetections, packets, dropped, overflowed);
+
+    packetsReceived += packets;
+    // Overflow is counted per detection, not per datagram
+    packetsDropped += dropped;
+    detectionsDropped += overflowed;
+    if (packets > 0) {
+        lastPacketTime = QDateTime::currentMSecsSinceEpoch();
+    }
 
-            detection.radial_speed = parts[2].toDouble(&ok);
-            if (!ok) continue;
+    outgoingBatch.reserve(static_cast<int>(pendingDetections.size()));
+    for (const auto& detection : pendingDetections) {
+        addDetection(detection);
+    }
+    recordStoreLatency();
 
-            detection.azimuth = parts[3].toDouble(&ok);
-            if (!ok) continue;
+    emitDetectionBatch();
+    emit detectionsUpdated();
+}
 
-            //detection.amplitude = parts.size() > 4 ? parts[4].toDouble() : 0.0;
-            //detection.timestamp = QDateTime::currentMSecsSinceEpoch();
-            //qDebug()<<"before adding";
-            if (isValidDetection(detection)) {
-                //qDebug()<<"adding";
-                addDetection(detection);
-                parsedAny = true;
-            }
-        }
+bool UdpHandler::parseDetectionData(const QByteArray& datagram, std::vector<DetectionData>& out)
+{
+    if (datagram.isEmpty()) {
+        return false;
     }
 
-    return parsedAny;
+    // JSON and CSV datagrams are not part of the sensor protocol and were
+    // never decoded here; DetectionParser::parseJson() / parseCsv() keep the
+    // old decoders but nothing in the ingest path calls them.
+    // Binary "DETS" frames and text lines are told apart by the leading magic;
+    // both are parsed in place without converting to QString
+    return DetectionParser::parse(datagram.constData(), static_cast<size_t>(datagram.size()), out) >= 0;
 }
 
 void UdpHandler::addDetection(const DetectionData& detection)
 {
-    //qDebug()<<"Added";
-    QMutexLocker locker(&detectionsMutex);
-    qDebug()<<detection.radius<<"\n";
-
-    detections.push_back(detection);
+    RADAR_LOG_DEBUG("Detection {} range {} m", detection.target_id, detection.radius);
 
-    // Emit signal for new detection
-    emit newDetectionReceived(detection);
+    // The ring retires the oldest entry itself once maxDetections are stored
+    detections.push(detection);
 
-    // Limit number of stored detections
-    if (static_cast<int>(detections.size()) > maxDetections) {
-        detections.erase(detections.begin(), detections.begin() + (detections.size() - maxDetections));
-    }
+    // Collected and emitted once per burst by emitDetectionBatch()
+    outgoingBatch.append(detection);
 }
 
-bool UdpHandler::isValidDetection(const DetectionData& detection) const
+void UdpHandler::emitDetectionBatch()
 {
-    // Basic validation
-    if (detection.target_id < 0 || detection.target_id > 999) {
-        return false;
-    }
-
-    if (detection.radius < 0 || detection.radius > 1000) { // 1km max range
-        return false;
-    }
-
-    if (detection.azimuth < -180 || detection.azimuth > 180) {
-        return false;
-    }
-
-    if (std::abs(detection.radial_speed) > 200) { // 200 m/s max speed
-        return false;
+    if (outgoingBatch.isEmpty()) {
+        return;
     }
 
-    return true;
+    // Receivers share the batch's data; the handler starts a fresh one
+    QVector<DetectionData> batch;
+    batch.swap(outgoingBatch);
+    emit detectionsBatchReceived(batch);
 }
 
 void UdpHandler::cleanupOldDetections()
 {
-    QMutexLocker locker(&detectionsMutex);
+    expireOldDetections();
+}
 
+void UdpHandler::expireOldDetections()
+{
     qint64 currentTime = QDateTime::currentMSecsSinceEpoch();
     qint64 cutoffTime = currentTime - detectionTimeoutMs;
 
-    // Remove old detections
-    detections.erase(
-        std::remove_if(detections.begin(), detections.end(),
-            [cutoffTime](const DetectionData& d) {
-                return d.timestamp < cutoffTime;
-            }),
-        detections.end());
+    // Detections are stored in arrival order, so expiring them only advances the tail
+    detections.advanceTailWhile([cutoffTime](const DetectionData& d) {
+        return d.timestamp < cutoffTime;
+    });
 }
 
 void UdpHandler::updateStatistics()
@@ -364,6 +419,7 @@ void UdpHandler::resetStatistics()
 {
     packetsReceived = 0;
     packetsDropped = 0;
+    detectionsDropped = 0;
     lastStatisticsUpdate = QDateTime::currentMSecsSinceEpoch();
     lastPacketTime = 0;
 }
@@ -377,12 +433,12 @@ void UdpHandler::setRemoteHost(const QString& host, int port)
 {
     remoteHost = host;
     remotePort = port;
-    qDebug() << "Remote host set to" << host << ":" << port;
+    RADAR_LOG_INFO("Remote host set to {}:{}", host, port);
 }
 
 bool UdpHandler::sendDSPSettings(const DSP_Settings_t& settings)
 {
-    if (!udpSocket || !connected) {
+    if ((!udpSocket && !receiver) || !connected) {
         emit errorOccurred("Cannot send DSP settings: Not connected");
         emit dspSettingsSent(false);
         return false;
@@ -414,18 +470,35 @@ bool UdpHandler::sendDSPSettings(const DSP_Settings_t& settings)
     // Add the DSP settings data
     packet.append(reinterpret_cast<const char*>(&settingsToSend), sizeof(DSP_Settings_t));
     
-    // Send the packet
+    // Send the packet; host names are not resolved, so the remote must be an address
     QHostAddress destAddress(remoteHost);
-    qint64 bytesSent = udpSocket->writeDatagram(packet, destAddress, remotePort);
+    if (destAddress.isNull()) {
+        emit errorOccurred(QString("Failed to send DSP settings: %1 is not an IP address").arg(remoteHost));
+        emit dspSettingsSent(false);
+        return false;
+    }
+    qint64 bytesSent = -1;
+    QString sendError;
+    if (receiver) {
+        // The socket belongs to the receive thread
+        UdpReceiver* worker = receiver.get();
+        quint16 port = static_cast<quint16>(remotePort);
+        QMetaObject::invokeMethod(worker, [worker, &packet, &destAddress, port, &sendError, &bytesSent]() {
+            bytesSent = worker->sendDatagram(packet, destAddress, port, &sendError);
+        }, Qt::BlockingQueuedConnection);
+    } else {
+        bytesSent = udpSocket->writeDatagram(packet, destAddress, remotePort);
+        sendError = udpSocket->errorString();
+    }
     
     if (bytesSent == -1) {
-        QString error = QString("Failed to send DSP settings: %1").arg(udpSocket->errorString());
+        QString error = QString("Failed to send DSP settings: %1").arg(sendError);
         emit errorOccurred(error);
         emit dspSettingsSent(false);
         return false;
     }
     
-    qDebug() << "DSP Settings sent:" << bytesSent << "bytes to" << remoteHost << ":" << remotePort;
+    RADAR_LOG_INFO("DSP settings sent: {} bytes to {}:{}", bytesSent, remoteHost, remotePort);
     emit dspSettingsSent(true);
     return true;
 }
@@ -3,6 +3,7 @@
 
 #include <QObject>
 #include <QUdpSocket>
+#include <QThread>
 #include <QTimer>
 #include <QMutex>
 #include <QHostAddress>
@@ -14,12 +15,24 @@
 #include <vector>
 #include <memory>
 #include "structures.h"
+#include "udpreceiver.h"
+#include "spscringbuffer.h"
+#include "trackassociator.h"
+
+class CaptureRecorder;
+class LatencyStats;
 
 class UdpHandler : public QObject
 {
     Q_OBJECT
 
 public:
+    // Where the socket is read and datagrams are parsed
+    enum IngestMode {
+        GuiThreadIngest,     // socket and parsing on the owning (GUI) thread
+        WorkerThreadIngest   // socket and parsing on a dedicated receive thread
+    };
+
     explicit UdpHandler(QObject *parent = nullptr);
     ~UdpHandler();
 
@@ -29,13 +42,16 @@ public:
     bool isConnected() const;
     
     // Configuration
-    void setMaxDetections(int max) { maxDetections = max; }
+    void setMaxDetections(int max);
     void setDetectionTimeout(int timeoutMs) { detectionTimeoutMs = timeoutMs; }
     void setRemoteHost(const QString& host, int port);
+    void setIngestMode(IngestMode mode) { ingestMode = mode; } // takes effect on next connectToHost
+    IngestMode getIngestMode() const { return ingestMode; }
     
     // Data access
     std::vector<DetectionData> getRecentDetections() const;
     int getDetectionCount() const;
+    void clearDetections();
     
     // Send DSP settings to radar
     bool sendDSPSettings(const DSP_Settings_t& settings);
@@ -43,11 +59,38 @@ public:
     // Statistics
     int getPacketsReceived() const { return packetsReceived; }
     int getPacketsDropped() const { return packetsDropped; }
+    int getDetectionsDropped() const { return detectionsDropped; }   // no room in the ingest queue
     double getDataRate() const; // packets per second
+    
+    // Parse one datagram and append its detections to out (thread-safe)
+    static bool parseDetectionData(const QByteArray& data, std::vector<DetectionData>& out);
+    
+    // Offline ingest (capture replay): feeds one raw datagram through the
+    // same parse and store path as the socket. Call flushIngestedDetections()
+    // after a burst to emit the batch. receiveTimeUs is on LatencyStats'
+    // clock; 0 means "now".
+    bool ingestDatagram(const char* data, int size, qint64 receiveTimeUs = 0);
+    void flushIngestedDetections();
+    
+    // Drops detections older than the timeout now rather than on the next
+    // cleanup tick, for offline tools and benchmarks
+    void expireOldDetections();
+    
+    // Raw datagram capture; the recorder must outlive the handler or be reset to nullptr first
+    void setCaptureRecorder(CaptureRecorder* recorder);
+    
+    // Per-stage latency recording (parse and store); same lifetime rule as the recorder
+    void setLatencyStats(LatencyStats* stats);
+    LatencyStats* getLatencyStats() const { return latencyStats; }
+    
+    // For firmware that does not keep TgtId stable between frames: derive
+    // target_id from range/azimuth/speed association instead (see TrackAssociator)
+    void setIdAssociation(bool enabled);
+    bool isIdAssociationEnabled() const { return idAssociation; }
 
 signals:
     void connectionStatusChanged(bool connected);
-    void newDetectionReceived(const DetectionData& detection);
+    void detectionsBatchReceived(const QVector<DetectionData>& detections); // once per datagram burst
     void detectionsUpdated();
     void errorOccurred(const QString& error);
     void statisticsUpdated(int packetsReceived, int packetsDropped, double dataRate);
@@ -55,6 +98,7 @@ signals:
 
 private slots:
     void readPendingDatagrams();
+    void processQueuedDetections();
     void cleanupOldDetections();
     void updateStatistics();
 
@@ -64,14 +108,25 @@ private:
     QString currentHost;
     int currentPort;
     bool connected;
+    IngestMode ingestMode;
+    CaptureRecorder* captureRecorder;
+    LatencyStats* latencyStats;
+    bool idAssociation;
+    TrackAssociator associator;   // GUI-thread ingest; the receiver has its own
+    
+    // Worker-thread ingest
+    std::unique_ptr<QThread> receiverThread;
+    std::unique_ptr<UdpReceiver> receiver;
+    DetectionQueue detectionQueue;
+    std::vector<DetectionData> pendingDetections;
+    QVector<DetectionData> outgoingBatch;
     
     // Remote destination for sending settings
     QString remoteHost;
     int remotePort;
     
-    // Data storage
-    mutable QMutex detectionsMutex;
-    std::vector<DetectionData> detections;
+    // Data storage: written by addDetection, trimmed by expireOldDetections
+    SpscRingBuffer<DetectionData> detections;
     int maxDetections;
     int detectionTimeoutMs;
     
@@ -80,19 +135,18 @@ private:
     QTimer* statisticsTimer;
     int packetsReceived;
     int packetsDropped;
+    int detectionsDropped;
     qint64 lastStatisticsUpdate;
     qint64 lastPacketTime;
     
-    // Data parsing
-    bool parseDetectionData(const QString& data);
-    bool parseJsonData(const QJsonDocument& doc);
-    bool parseCsvData(const QString& csvData);
+    // Data storage
     void addDetection(const DetectionData& detection);
-    
-    // Validation
-    bool isValidDetection(const DetectionData& detection) const;
+    void recordStoreLatency();
+    void emitDetectionBatch();
     
     // Helper functions
+    bool startReceiverThread(const QHostAddress& bindAddress, int port, QString* error);
+    void stopReceiverThread();
     void resetStatistics();
     void emitStatistics();
 };
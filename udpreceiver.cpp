@@ -0,0 +1,354 @@
+#include "udpreceiver.h"
+#include "udphandler.h"
+#include "capturerecorder.h"
+#include "latencystats.h"
+#include <QMutexLocker>
+
+#ifdef Q_OS_LINUX
+#include <netinet/in.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+// DetectionQueue Implementation
+DetectionQueue::DetectionQueue(size_t capacity)
+    : capacity(capacity)
+    , pendingPackets(0)
+    , pendingDropped(0)
+    , pendingOverflow(0)
+    , wakeupPending(false)
+{
+    pending.reserve(capacity);
+}
+
+bool DetectionQueue::push(const std::vector<DetectionData>& batch, int packets, int dropped)
+{
+    QMutexLocker locker(&mutex);
+
+    size_t space = capacity - pending.size();
+    size_t accepted = qMin(space, batch.size());
+    pending.insert(pending.end(), batch.begin(), batch.begin() + accepted);
+
+    pendingPackets += packets;
+    pendingDropped += dropped;
+    pendingOverflow += static_cast<int>(batch.size() - accepted);
+
+    // Only the first push after a drain needs to wake the consumer
+    bool wakeup = !wakeupPending;
+    wakeupPending = true;
+    return wakeup;
+}
+
+void DetectionQueue::drain(std::vector<DetectionData>& out, int& packets, int& dropped, int& overflowed)
+{
+    out.clear();
+
+    QMutexLocker locker(&mutex);
+    out.swap(pending);
+    pending.reserve(capacity);
+
+    packets = pendingPackets;
+    dropped = pendingDropped;
+    overflowed = pendingOverflow;
+    pendingPackets = 0;
+    pendingDropped = 0;
+    pendingOverflow = 0;
+    wakeupPending = false;
+}
+
+void DetectionQueue::clear()
+{
+    QMutexLocker locker(&mutex);
+    pending.clear();
+    pendingPackets = 0;
+    pendingDropped = 0;
+    pendingOverflow = 0;
+    wakeupPending = false;
+}
+
+// UdpReceiver Implementation
+UdpReceiver::UdpReceiver(DetectionQueue* queue, QObject* parent)
+    : QObject(parent)
+    , queue(queue)
+    , captureRecorder(nullptr)
+    , latencyStats(nullptr)
+    , socketFd(-1)
+    , idAssociation(false)
+    , drainPackets(0)
+    , drainDropped(0)
+{
+}
+
+UdpReceiver::~UdpReceiver()
+{
+    close();
+}
+
+bool UdpReceiver::open(const QHostAddress& address, quint16 port, QString* error)
+{
+    close();
+
+#ifdef Q_OS_LINUX
+    // Batched recvmmsg ingest for IPv4, Qt socket for everything else
+    if (address == QHostAddress::Any || address.protocol() == QAbstractSocket::IPv4Protocol) {
+        return openNative(address, port, error);
+    }
+#endif
+
+    socket = std::make_unique<QUdpSocket>();
+    if (!socket->bind(address, port)) {
+        if (error) {
+            *error = socket->errorString();
+        }
+        socket.reset();
+        return false;
+    }
+
+    socket->setSocketOption(QAbstractSocket::ReceiveBufferSizeSocketOption, RECEIVE_BUFFER_BYTES);
+    datagramBuffer.resize(MAX_DATAGRAM_SIZE);
+    parsedDetections.reserve(BATCH_SIZE * 4);
+
+    connect(socket.get(), &QUdpSocket::readyRead, this, &UdpReceiver::drainSocket);
+    return true;
+}
+
+void UdpReceiver::close()
+{
+    notifier.reset();
+
+#ifdef Q_OS_LINUX
+    if (socketFd >= 0) {
+        ::close(socketFd);
+        socketFd = -1;
+    }
+#endif
+
+    if (socket) {
+        socket->close();
+        socket.reset();
+    }
+}
+
+bool UdpReceiver::isOpen() const
+{
+    return socketFd >= 0 || (socket && socket->state() == QAbstractSocket::BoundState);
+}
+
+qint64 UdpReceiver::sendDatagram(const QByteArray& data, const QHostAddress& address, quint16 port, QString* error)
+{
+#ifdef Q_OS_LINUX
+    if (socketFd >= 0) {
+        // toIPv4Address() is 0 for IPv6 and null addresses, which would send to 0.0.0.0
+        if (address.protocol() != QAbstractSocket::IPv4Protocol) {
+            if (error) {
+                *error = QString("Not an IPv4 address: %1").arg(address.toString());
+            }
+            return -1;
+        }
+
+        sockaddr_in destination;
+        std::memset(&destination, 0, sizeof(destination));
+        destination.sin_family = AF_INET;
+        destination.sin_port = htons(port);
+        destination.sin_addr.s_addr = htonl(address.toIPv4Address());
+
+        ssize_t sent = ::sendto(socketFd, data.constData(), data.size(), 0,
+                                reinterpret_cast<const sockaddr*>(&destination), sizeof(destination));
+        if (sent < 0 && error) {
+            *error = QString::fromLocal8Bit(std::strerror(errno));
+        }
+        return sent;
+    }
+#endif
+
+    if (!socket) {
+        if (error) {
+            *error = "Socket not open";
+        }
+        return -1;
+    }
+
+    qint64 sent = socket->writeDatagram(data, address, port);
+    if (sent < 0 && error) {
+        *error = socket->errorString();
+    }
+    return sent;
+}
+
+void UdpReceiver::drainSocket()
+{
+#ifdef Q_OS_LINUX
+    if (socketFd >= 0) {
+        drainNative();
+        return;
+    }
+#endif
+    drainPortable();
+}
+
+void UdpReceiver::processDatagram(const char* data, int size, qint64 receiveTimeUs)
+{
+    if (CaptureRecorder* recorder = captureRecorder.load(std::memory_order_acquire)) {
+        recorder->append(data, size, CaptureFile::nowUs());
+    }
+
+    size_t first = parsedDetections.size();
+    if (!UdpHandler::parseDetectionData(QByteArray::fromRawData(data, size), parsedDetections)) {
+        drainDropped++;
+        return;
+    }
+    drainPackets++;
+
+    for (size_t i = first; i < parsedDetections.size(); ++i) {
+        parsedDetections[i].receive_time_us = receiveTimeUs;
+    }
+    if (idAssociation) {
+        associator.associate(parsedDetections.data() + first, parsedDetections.size() - first, receiveTimeUs);
+    }
+    if (LatencyStats* stats = latencyStats.load(std::memory_order_acquire)) {
+        stats->record(LatencyStats::ParseStage, receiveTimeUs, LatencyStats::nowUs(),
+                      parsedDetections.size() - first);
+    }
+}
+
+void UdpReceiver::setIdAssociation(bool enabled)
+{
+    idAssociation = enabled;
+    associator.reset();
+}
+
+void UdpReceiver::flushToQueue()
+{
+    if (drainPackets == 0 && drainDropped == 0) {
+        return;
+    }
+
+    if (queue->push(parsedDetections, drainPackets, drainDropped)) {
+        emit detectionsReady();
+    }
+
+    parsedDetections.clear();
+    drainPackets = 0;
+    drainDropped = 0;
+}
+
+void UdpReceiver::drainPortable()
+{
+    if (!socket) {
+        return;
+    }
+
+    int processed = 0;
+    while (socket->hasPendingDatagrams() && processed < BATCH_SIZE * MAX_BATCHES_PER_WAKEUP) {
+        // readDatagram truncates silently; a cut-off datagram must never be parsed
+        if (socket->pendingDatagramSize() > static_cast<qint64>(datagramBuffer.size())) {
+            socket->readDatagram(nullptr, 0);
+            drainDropped++;
+        } else {
+            qint64 size = socket->readDatagram(datagramBuffer.data(), datagramBuffer.size());
+            if (size >= 0) {
+                processDatagram(datagramBuffer.constData(), static_cast<int>(size), LatencyStats::nowUs());
+            }
+        }
+        processed++;
+    }
+
+    flushToQueue();
+}
+
+#ifdef Q_OS_LINUX
+bool UdpReceiver::openNative(const QHostAddress& address, quint16 port, QString* error)
+{
+    bool anyAddress = address == QHostAddress::Any || address == QHostAddress::AnyIPv4;
+    if (!anyAddress && address.protocol() != QAbstractSocket::IPv4Protocol) {
+        if (error) {
+            *error = QString("Not an IPv4 address: %1").arg(address.toString());
+        }
+        return false;
+    }
+
+    socketFd = ::socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (socketFd < 0) {
+        if (error) {
+            *error = QString::fromLocal8Bit(std::strerror(errno));
+        }
+        return false;
+    }
+
+    int reuse = 1;
+    ::setsockopt(socketFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    int receiveBuffer = RECEIVE_BUFFER_BYTES;
+    ::setsockopt(socketFd, SOL_SOCKET, SO_RCVBUF, &receiveBuffer, sizeof(receiveBuffer));
+
+    sockaddr_in bindAddress;
+    std::memset(&bindAddress, 0, sizeof(bindAddress));
+    bindAddress.sin_family = AF_INET;
+    bindAddress.sin_port = htons(port);
+    bindAddress.sin_addr.s_addr = anyAddress ? htonl(INADDR_ANY) : htonl(address.toIPv4Address());
+
+    if (::bind(socketFd, reinterpret_cast<const sockaddr*>(&bindAddress), sizeof(bindAddress)) < 0) {
+        if (error) {
+            *error = QString::fromLocal8Bit(std::strerror(errno));
+        }
+        ::close(socketFd);
+        socketFd = -1;
+        return false;
+    }
+
+    // One contiguous buffer, one iovec and one mmsghdr per batch slot
+    batchBuffer.resize(static_cast<size_t>(BATCH_SIZE) * MAX_DATAGRAM_SIZE);
+    messageVectors.resize(BATCH_SIZE);
+    messageHeaders.resize(BATCH_SIZE);
+    for (int i = 0; i < BATCH_SIZE; ++i) {
+        messageVectors[i].iov_base = batchBuffer.data() + static_cast<size_t>(i) * MAX_DATAGRAM_SIZE;
+        messageVectors[i].iov_len = MAX_DATAGRAM_SIZE;
+        std::memset(&messageHeaders[i], 0, sizeof(mmsghdr));
+        messageHeaders[i].msg_hdr.msg_iov = &messageVectors[i];
+        messageHeaders[i].msg_hdr.msg_iovlen = 1;
+    }
+    parsedDetections.reserve(BATCH_SIZE * 4);
+
+    // QSocketNotifier::activated is overloaded in Qt 5.15 and only takes the descriptor before it
+    notifier = std::make_unique<QSocketNotifier>(socketFd, QSocketNotifier::Read);
+#if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0) && QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    connect(notifier.get(), QOverload<QSocketDescriptor, QSocketNotifier::Type>::of(&QSocketNotifier::activated),
+            this, &UdpReceiver::drainSocket);
+#else
+    connect(notifier.get(), &QSocketNotifier::activated, this, &UdpReceiver::drainSocket);
+#endif
+    return true;
+}
+
+void UdpReceiver::drainNative()
+{
+    for (int batch = 0; batch < MAX_BATCHES_PER_WAKEUP; ++batch) {
+        int received = ::recvmmsg(socketFd, messageHeaders.data(), BATCH_SIZE, MSG_DONTWAIT, nullptr);
+        if (received < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                emit errorOccurred(QString("UDP Socket Error: %1").arg(QString::fromLocal8Bit(std::strerror(errno))));
+            }
+            break;
+        }
+
+        // One receipt time for the whole batch; recvmmsg returned them together
+        qint64 receiveTimeUs = LatencyStats::nowUs();
+        for (int i = 0; i < received; ++i) {
+            const mmsghdr& message = messageHeaders[i];
+            if (message.msg_hdr.msg_flags & MSG_TRUNC) {
+                drainDropped++;
+                continue;
+            }
+            processDatagram(static_cast<const char*>(messageVectors[i].iov_base),
+                            static_cast<int>(message.msg_len), receiveTimeUs);
+        }
+
+        if (received < BATCH_SIZE) {
+            break;
+        }
+    }
+
+    // Level-triggered notifier fires again if more data is waiting
+    flushToQueue();
+}
+#endif
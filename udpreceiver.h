@@ -0,0 +1,120 @@
+#ifndef UDPRECEIVER_H
+#define UDPRECEIVER_H
+
+#include <QObject>
+#include <QUdpSocket>
+#include <QSocketNotifier>
+#include <QHostAddress>
+#include <QMutex>
+#include <atomic>
+#include <vector>
+#include <memory>
+#include "structures.h"
+#include "trackassociator.h"
+
+class CaptureRecorder;
+class LatencyStats;
+
+#ifdef Q_OS_LINUX
+#include <sys/socket.h>
+#endif
+
+// Bounded hand-off queue between the receive thread and the GUI thread.
+// The receive thread appends one batch per socket drain, the GUI thread
+// takes everything in one swap. Detections that do not fit are discarded
+// and counted, so a stalled GUI can never grow memory without bound.
+class DetectionQueue
+{
+public:
+    explicit DetectionQueue(size_t capacity = 16384);
+
+    // Producer side. Returns true when the queue was empty before this push,
+    // i.e. when the consumer has to be woken up.
+    bool push(const std::vector<DetectionData>& batch, int packets, int dropped);
+
+    // Consumer side. Swaps out all pending detections and the packet counters
+    // accumulated since the previous drain.
+    void drain(std::vector<DetectionData>& out, int& packets, int& dropped, int& overflowed);
+
+    void clear();
+
+private:
+    mutable QMutex mutex;
+    std::vector<DetectionData> pending;
+    size_t capacity;
+    int pendingPackets;
+    int pendingDropped;
+    int pendingOverflow;
+    bool wakeupPending;
+};
+
+// Socket owner for the worker-thread ingest mode. Lives on its own QThread,
+// drains the socket in batches (recvmmsg on Linux, readDatagram elsewhere),
+// parses the datagrams and hands the detections to a DetectionQueue.
+class UdpReceiver : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit UdpReceiver(DetectionQueue* queue, QObject* parent = nullptr);
+    ~UdpReceiver();
+
+    // Must be called from the receiver's thread (e.g. via BlockingQueuedConnection)
+    bool open(const QHostAddress& address, quint16 port, QString* error);
+    void close();
+    bool isOpen() const;
+    qint64 sendDatagram(const QByteArray& data, const QHostAddress& address, quint16 port, QString* error);
+    void setCaptureRecorder(CaptureRecorder* recorder) { captureRecorder.store(recorder, std::memory_order_release); }
+    void setLatencyStats(LatencyStats* stats) { latencyStats.store(stats, std::memory_order_release); }
+    void setIdAssociation(bool enabled);   // receive thread only
+
+signals:
+    void detectionsReady();
+    void errorOccurred(const QString& error);
+
+private slots:
+    void drainSocket();
+
+private:
+    DetectionQueue* queue;
+    std::atomic<CaptureRecorder*> captureRecorder;   // raw datagram capture, may be null
+    std::atomic<LatencyStats*> latencyStats;         // per-stage latency, may be null
+
+    // Portable path
+    std::unique_ptr<QUdpSocket> socket;
+    QByteArray datagramBuffer;
+
+    // Native Linux path
+    int socketFd;
+    std::unique_ptr<QSocketNotifier> notifier;
+#ifdef Q_OS_LINUX
+    std::vector<mmsghdr> messageHeaders;
+    std::vector<iovec> messageVectors;
+    std::vector<char> batchBuffer;
+#endif
+
+    // Replaces sensor target IDs when they are not stable across frames
+    bool idAssociation;
+    TrackAssociator associator;
+
+    // Per-drain scratch, reused to avoid reallocations
+    std::vector<DetectionData> parsedDetections;
+    int drainPackets;
+    int drainDropped;
+
+    void processDatagram(const char* data, int size, qint64 receiveTimeUs);
+    void flushToQueue();
+#ifdef Q_OS_LINUX
+    bool openNative(const QHostAddress& address, quint16 port, QString* error);
+    void drainNative();
+#endif
+    void drainPortable();
+
+    // Batch and buffer sizing
+    static constexpr int BATCH_SIZE = 64;
+    static constexpr int MAX_DATAGRAM_SIZE = 65507;   // largest UDP payload over IPv4
+    static constexpr int MAX_BATCHES_PER_WAKEUP = 16;
+    static constexpr int RECEIVE_BUFFER_BYTES = 4 * 1024 * 1024;
+};
+
+#endif // UDPRECEIVER_H